@@ -0,0 +1,564 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// Detray include(s).
+#include "detray/definitions/indexing.hpp"
+#include "detray/definitions/units.hpp"
+#include "detray/intersection/detail/trajectories.hpp"
+#include "detray/intersection/intersection.hpp"
+#include "detray/intersection/intersection_kernel.hpp"
+#include "detray/utils/enumerate.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace detray::tutorial {
+
+/// Flat list of the object (surface and portal) indices of every volume.
+///
+/// The objects of a volume never change during propagation, so the lists are
+/// built once per detector and shared by all tracks.
+template <typename detector_t>
+class volume_candidate_index
+{
+    public:
+    explicit volume_candidate_index(const detector_t &det)
+    {
+        _offsets.reserve(det.volumes().size() + 1);
+        _offsets.push_back(0);
+
+        for (const auto &v : det.volumes())
+        {
+            for (const auto [sf_idx, sf] : enumerate(det.surfaces(), v))
+            {
+                _indices.push_back(static_cast<dindex>(sf_idx));
+            }
+            _offsets.push_back(_indices.size());
+        }
+    }
+
+    const dindex *begin(const dindex volume) const
+    {
+        return _indices.data() + _offsets[volume];
+    }
+
+    const dindex *end(const dindex volume) const
+    {
+        return _indices.data() + _offsets[volume + 1];
+    }
+
+    std::size_t size(const dindex volume) const
+    {
+        return _offsets[volume + 1] - _offsets[volume];
+    }
+
+    std::size_t n_volumes() const { return _offsets.size() - 1; }
+
+    private:
+    std::vector<std::size_t> _offsets{};
+    std::vector<dindex> _indices{};
+};
+
+/// Candidate of the navigation stream: surface index, straight line
+/// intersection and the walked path at which the surface is expected.
+struct cached_candidate
+{
+    dindex sf_index{dindex_invalid};
+    scalar key{std::numeric_limits<scalar>::max()};
+    /// Walked path at which the tangent crosses the surface of a candidate it
+    /// missed
+    scalar crossing{std::numeric_limits<scalar>::max()};
+    line_plane_intersection sfi{};
+
+    bool is_valid() const
+    {
+        return key < std::numeric_limits<scalar>::max();
+    }
+
+    bool operator<(const cached_candidate &rhs) const { return key < rhs.key; }
+    bool operator>(const cached_candidate &rhs) const { return key > rhs.key; }
+};
+
+/// Common part of the candidate lists: intersection of a single object
+template <typename detector_t>
+class candidate_list_base
+{
+    public:
+    candidate_list_base(const detector_t &det,
+                        const volume_candidate_index<detector_t> &index)
+        : _detector(&det), _index(&index)
+    {
+    }
+
+    /// Number of surface intersections run since construction
+    std::size_t n_intersections() const { return _n_intersections; }
+
+    /// Objects closer than this are the ones the track is currently on
+    scalar on_surface_tolerance{5. * unit_constants::um};
+
+    protected:
+    /// Intersect the candidate with the tangent ray of @param track and
+    /// translate the distance into a key on the walked path
+    template <typename track_t>
+    void intersect(cached_candidate &cand, const track_t &track,
+                   const scalar walked)
+    {
+        const auto &sf = _detector->surfaces()[cand.sf_index];
+
+        cand.sfi =
+            _detector->mask_store().template execute<intersection_update>(
+                sf.mask_type(), detail::ray(track), sf,
+                _detector->transform_store());
+        ++_n_intersections;
+
+        cand.key = (cand.sfi.status == intersection::status::e_inside and
+                    cand.sfi.path > on_surface_tolerance)
+                       ? walked + cand.sfi.path
+                       : std::numeric_limits<scalar>::max();
+    }
+
+    const detector_t *_detector;
+    const volume_candidate_index<detector_t> *_index;
+    std::size_t _n_intersections{0};
+};
+
+/// Reference behaviour of the navigator: every update intersects all objects
+/// of the volume and sorts the complete candidate list.
+template <typename detector_t>
+class sorted_candidates : public candidate_list_base<detector_t>
+{
+    using base_type = candidate_list_base<detector_t>;
+
+    public:
+    using base_type::base_type;
+
+    template <typename track_t>
+    void init(const dindex volume, const track_t &track, const scalar walked)
+    {
+        _candidates.clear();
+        for (auto itr = this->_index->begin(volume);
+             itr != this->_index->end(volume); ++itr)
+        {
+            _candidates.push_back({*itr});
+        }
+        update(track, walked);
+    }
+
+    template <typename track_t>
+    void update(const track_t &track, const scalar walked)
+    {
+        for (auto &cand : _candidates)
+        {
+            this->intersect(cand, track, walked);
+        }
+        std::sort(_candidates.begin(), _candidates.end());
+    }
+
+    bool has_next() const
+    {
+        return not _candidates.empty() and _candidates.front().is_valid();
+    }
+
+    const cached_candidate &next() const { return _candidates.front(); }
+
+    private:
+    std::vector<cached_candidate> _candidates{};
+};
+
+/// Candidate list that is updated incrementally as the track moves.
+///
+/// Only the @c n_exact closest candidates (the head) are re-intersected at
+/// every update and kept sorted. The other objects that the tangent of the
+/// track hits sit in a min-heap, keyed by the walked path at which they were
+/// expected when last intersected. A heap entry is only re-intersected once
+/// its key undercuts the exact head. For a straight line the keys stay exact.
+///
+/// In a field, the track curves away from the tangent it was intersected
+/// with: at the distance L, the tangent is off by about kappa L^2 / 2 for the
+/// curvature kappa, so an object the tangent missed can still be hit. Missed
+/// objects are kept in a second min-heap, keyed by the walked path at which
+/// the tangent crosses their surface, as long as the drift up to there
+/// exceeds @c drift_tolerance. Like the heap entries, they are only
+/// intersected again while that crossing lies within the head, where they
+/// could replace one of its candidates.
+///
+/// An update thus intersects the head and the objects whose surfaces lie
+/// within the reach of the head. Its cost depends on the density of the
+/// objects around the track, but not on the number of objects in the volume.
+template <typename detector_t>
+class incremental_candidates : public candidate_list_base<detector_t>
+{
+    using base_type = candidate_list_base<detector_t>;
+
+    public:
+    /// @param b_max upper bound of the magnetic field strength along the
+    ///        track, zero for straight tracks
+    incremental_candidates(const detector_t &det,
+                           const volume_candidate_index<detector_t> &index,
+                           const std::size_t n_exact = 4,
+                           const scalar b_max = 0.)
+        : base_type(det, index),
+          _n_exact(std::max<std::size_t>(n_exact, 1)),
+          _b_max(b_max)
+    {
+    }
+
+    /// Drift of the track away from its tangent below which a missed object
+    /// is not intersected again
+    scalar drift_tolerance{1. * unit_constants::um};
+
+    /// Fill the candidates of @param volume from the precomputed index list
+    template <typename track_t>
+    void init(const dindex volume, const track_t &track, const scalar walked)
+    {
+        _curvature = std::abs(track.qop()) * _b_max;
+
+        _on_surface = {};
+        _head.clear();
+        _heap.clear();
+        _missed.clear();
+        for (auto itr = this->_index->begin(volume);
+             itr != this->_index->end(volume); ++itr)
+        {
+            _head.push_back({*itr});
+            intersect(_head.back(), track, walked);
+        }
+        select_head();
+    }
+
+    template <typename track_t>
+    void update(const track_t &track, const scalar walked)
+    {
+        // The head is always exact
+        _on_surface = {};
+        std::size_t n_valid{0};
+        scalar bound{-std::numeric_limits<scalar>::max()};
+        for (auto &cand : _head)
+        {
+            intersect(cand, track, walked);
+            if (cand.sfi.status == intersection::status::e_inside and
+                std::abs(cand.sfi.path) <= this->on_surface_tolerance)
+            {
+                _on_surface = cand;
+            }
+            if (cand.is_valid())
+            {
+                ++n_valid;
+                bound = std::max(bound, cand.key);
+            }
+        }
+
+        // Pull stale entries that could be closer than the current head
+        while (not _heap.empty() and
+               (n_valid < _n_exact or _heap.front().key < bound))
+        {
+            cached_candidate cand = pop(_heap, std::greater<>{});
+
+            intersect(cand, track, walked);
+            if (cand.is_valid() and n_valid++ < _n_exact)
+            {
+                bound = std::max(bound, cand.key);
+            }
+            _head.push_back(cand);
+        }
+
+        // Missed objects within the head, the track may have curved into them
+        while (not _missed.empty() and _missed.front().crossing < bound)
+        {
+            cached_candidate cand = pop(_missed, later_crossing);
+
+            intersect(cand, track, walked);
+            if (cand.is_valid() and n_valid++ < _n_exact)
+            {
+                bound = std::max(bound, cand.key);
+            }
+            _head.push_back(cand);
+        }
+
+        select_head();
+    }
+
+    bool has_next() const
+    {
+        return not _head.empty() and _head.front().is_valid();
+    }
+
+    const cached_candidate &next() const { return _head.front(); }
+
+    /// Object of the head that the track was on at the last update, if any
+    const cached_candidate *on_surface() const
+    {
+        return _on_surface.sf_index != dindex_invalid ? &_on_surface
+                                                      : nullptr;
+    }
+
+    private:
+    /// Intersect @param cand and, if the tangent misses it, note where the
+    /// track could still curve into it
+    template <typename track_t>
+    void intersect(cached_candidate &cand, const track_t &track,
+                   const scalar walked)
+    {
+        base_type::intersect(cand, track, walked);
+
+        const scalar dist = cand.sfi.path;
+        const scalar drift = scalar{0.5} * _curvature * dist * dist;
+        cand.crossing = (not cand.is_valid() and
+                         dist > this->on_surface_tolerance and
+                         drift > drift_tolerance)
+                            ? walked + dist
+                            : std::numeric_limits<scalar>::max();
+    }
+
+    /// Keep the @c n_exact closest entries of the head and park the rest:
+    /// hits on the heap, misses that may still turn into hits on the heap of
+    /// missed objects. All other entries are behind the track and dropped.
+    void select_head()
+    {
+        if (_head.size() > _n_exact)
+        {
+            std::nth_element(_head.begin(), _head.begin() + _n_exact,
+                             _head.end());
+            for (auto itr = _head.begin() + _n_exact; itr != _head.end();
+                 ++itr)
+            {
+                if (itr->is_valid())
+                {
+                    push(_heap, *itr, std::greater<>{});
+                }
+                else if (itr->crossing < std::numeric_limits<scalar>::max())
+                {
+                    push(_missed, *itr, later_crossing);
+                }
+            }
+            _head.resize(_n_exact);
+        }
+        std::sort(_head.begin(), _head.end());
+    }
+
+    static bool later_crossing(const cached_candidate &a,
+                               const cached_candidate &b)
+    {
+        return a.crossing > b.crossing;
+    }
+
+    template <typename compare_t>
+    static void push(std::vector<cached_candidate> &heap,
+                     const cached_candidate &cand, compare_t &&comp)
+    {
+        heap.push_back(cand);
+        std::push_heap(heap.begin(), heap.end(), comp);
+    }
+
+    template <typename compare_t>
+    static cached_candidate pop(std::vector<cached_candidate> &heap,
+                                compare_t &&comp)
+    {
+        std::pop_heap(heap.begin(), heap.end(), comp);
+        cached_candidate cand = heap.back();
+        heap.pop_back();
+        return cand;
+    }
+
+    std::size_t _n_exact;
+    scalar _b_max;
+    scalar _curvature{0.};
+    cached_candidate _on_surface{};
+    std::vector<cached_candidate> _head{};
+    std::vector<cached_candidate> _heap{};
+    std::vector<cached_candidate> _missed{};
+};
+
+/// Navigator on incremental candidate lists, a drop-in replacement for
+/// @c navigator<detector_t> in the @c propagator.
+///
+/// Its state offers the part of the navigation state that the steppers,
+/// stepper policies and actors of the tutorials use. Every volume the track
+/// enters fills an @c incremental_candidates list from the precomputed index,
+/// and every update refreshes that list. As in the navigator, a surface is
+/// reached when its new intersection puts the track on it, so that a step
+/// that ended short of the surface on a curved track is followed by another.
+template <typename detector_t>
+class incremental_navigator
+{
+    public:
+    using detector_type = detector_t;
+    using intersection_type = line_plane_intersection;
+    using candidates_type = incremental_candidates<detector_t>;
+
+    enum class status : std::uint8_t
+    {
+        e_abort = 0,
+        e_exit = 1,
+        e_towards_object = 2,
+        e_on_module = 3,
+        e_on_portal = 4
+    };
+
+    class state
+    {
+        friend class incremental_navigator;
+
+        public:
+        state() = default;
+
+        /// The propagator state may hand over a candidate buffer, which this
+        /// navigator does not need
+        template <typename buffer_t>
+        explicit state(buffer_t &&)
+        {
+        }
+
+        /// Distance to the next candidate
+        scalar operator()() const
+        {
+            return _candidates->next().key - _walked;
+        }
+
+        /// The surface the track is on
+        const intersection_type *current() const { return &_current; }
+
+        dindex volume() const { return _volume; }
+
+        void set_volume(const dindex volume) { _volume = volume; }
+
+        bool is_on_module() const { return _status == status::e_on_module; }
+
+        bool is_on_portal() const { return _status == status::e_on_portal; }
+
+        /// The track left the detector
+        bool is_complete() const { return _status == status::e_exit; }
+
+        /// Stop the navigation, @returns the heartbeat
+        bool abort()
+        {
+            _status = status::e_abort;
+            return false;
+        }
+
+        // The head of the candidates is exact at every update, there is
+        // nothing to trust
+        void set_no_trust() {}
+        void set_fair_trust() {}
+        void set_high_trust() {}
+        void set_full_trust() {}
+
+        /// Number of surface intersections run for this track
+        std::size_t n_intersections() const
+        {
+            return _candidates ? _candidates->n_intersections() : 0;
+        }
+
+        private:
+        std::optional<candidates_type> _candidates{};
+        intersection_type _current{};
+        dindex _volume{0};
+        scalar _walked{0.};
+        status _status{status::e_towards_object};
+    };
+
+    /// @param n_exact number of candidates that are kept exact
+    /// @param b_max upper bound of the magnetic field strength
+    incremental_navigator(const detector_t &det,
+                          const volume_candidate_index<detector_t> &index,
+                          const std::size_t n_exact = 4,
+                          const scalar b_max = 0.)
+        : _detector(&det), _index(&index), _n_exact(n_exact), _b_max(b_max)
+    {
+    }
+
+    /// Fill the candidates of the start volume
+    ///
+    /// @returns the heartbeat
+    template <typename propagator_state_t>
+    bool init(propagator_state_t &propagation) const
+    {
+        state &navigation = propagation._navigation;
+        const auto &stepping = propagation._stepping;
+
+        navigation._candidates.emplace(*_detector, *_index, _n_exact, _b_max);
+        navigation._walked = stepping.path_length();
+        navigation._status = status::e_towards_object;
+        navigation._candidates->init(navigation._volume, stepping(),
+                                     navigation._walked);
+
+        return has_next(navigation);
+    }
+
+    /// Check whether the step reached the next candidate and update the
+    /// candidates
+    ///
+    /// @returns the heartbeat
+    template <typename propagator_state_t>
+    bool update(propagator_state_t &propagation) const
+    {
+        state &navigation = propagation._navigation;
+        if (navigation._status == status::e_abort or
+            navigation._status == status::e_exit)
+        {
+            return false;
+        }
+
+        const auto &stepping = propagation._stepping;
+        const auto &track = stepping();
+        auto &candidates = *navigation._candidates;
+
+        navigation._walked = stepping.path_length();
+        candidates.update(track, navigation._walked);
+
+        const cached_candidate *reached = candidates.on_surface();
+        if (reached == nullptr)
+        {
+            navigation._status = status::e_towards_object;
+            return has_next(navigation);
+        }
+        navigation._current = reached->sfi;
+        navigation._current.index = reached->sf_index;
+
+        // Module: the candidates already moved on to the next surface
+        if (reached->sfi.link == navigation._volume)
+        {
+            navigation._status = status::e_on_module;
+            return has_next(navigation);
+        }
+
+        // Portal: switch to the next volume, unless the track leaves
+        navigation._volume = reached->sfi.link;
+        if (navigation._volume >= _detector->volumes().size())
+        {
+            navigation._status = status::e_exit;
+            return false;
+        }
+        navigation._status = status::e_on_portal;
+        candidates.init(navigation._volume, track, navigation._walked);
+
+        return has_next(navigation);
+    }
+
+    private:
+    /// A track without a candidate ahead is lost
+    static bool has_next(state &navigation)
+    {
+        if (not navigation._candidates->has_next())
+        {
+            navigation._status = status::e_abort;
+            return false;
+        }
+        return true;
+    }
+
+    const detector_t *_detector;
+    const volume_candidate_index<detector_t> *_index;
+    std::size_t _n_exact;
+    scalar _b_max;
+};
+
+}  // namespace detray::tutorial
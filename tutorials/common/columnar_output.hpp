@@ -0,0 +1,474 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// System include(s).
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace detray::tutorial {
+
+/// Propagation result on a single surface
+struct surface_hit
+{
+    std::uint64_t track_id{0};
+    std::uint32_t volume_id{0};
+    std::uint32_t surface_id{0};
+    float path{0.f};
+    std::array<float, 2> local{};
+    std::array<float, 3> dir{};
+
+    bool operator==(const surface_hit &rhs) const
+    {
+        return track_id == rhs.track_id and volume_id == rhs.volume_id and
+               surface_id == rhs.surface_id and path == rhs.path and
+               local == rhs.local and dir == rhs.dir;
+    }
+};
+
+/// Columns of the surface hit file
+enum class column : std::uint8_t
+{
+    e_track_id = 0,
+    e_volume_id = 1,
+    e_surface_id = 2,
+    e_path = 3,
+    e_loc0 = 4,
+    e_loc1 = 5,
+    e_dir_x = 6,
+    e_dir_y = 7,
+    e_dir_z = 8,
+    e_n_columns = 9
+};
+
+/// Encodings of a column chunk
+enum class encoding : std::uint8_t
+{
+    e_delta_varint = 0,  ///< zig-zag delta to the previous row, LEB128 varint
+    e_dictionary = 1,    ///< distinct values of the chunk + varint codes
+    e_plain_float = 2    ///< raw IEEE floats in host byte order
+};
+
+namespace detail {
+
+constexpr char file_magic[8] = {'D', 'T', 'R', 'Y', 'C', 'O', 'L', '\0'};
+constexpr std::uint32_t file_version = 1;
+
+inline void put_varint(std::vector<char> &buf, std::uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        buf.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    buf.push_back(static_cast<char>(v));
+}
+
+inline std::uint64_t get_varint(const char *&ptr, const char *end)
+{
+    std::uint64_t v{0};
+    for (unsigned int shift = 0; ptr != end and shift < 64; shift += 7)
+    {
+        const auto byte = static_cast<std::uint8_t>(*ptr++);
+        v |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (not(byte & 0x80))
+        {
+            return v;
+        }
+    }
+    throw std::runtime_error("Corrupt varint in columnar file");
+}
+
+inline std::uint64_t zigzag(const std::int64_t v)
+{
+    return (static_cast<std::uint64_t>(v) << 1) ^
+           static_cast<std::uint64_t>(v >> 63);
+}
+
+inline std::int64_t unzigzag(const std::uint64_t v)
+{
+    return static_cast<std::int64_t>(v >> 1) ^
+           -static_cast<std::int64_t>(v & 1);
+}
+
+template <typename T>
+inline void put_raw(std::vector<char> &buf, const T &v)
+{
+    const auto pos = buf.size();
+    buf.resize(pos + sizeof(T));
+    std::memcpy(buf.data() + pos, &v, sizeof(T));
+}
+
+template <typename T>
+inline T get_raw(std::istream &in)
+{
+    T v;
+    if (not in.read(reinterpret_cast<char *>(&v), sizeof(T)))
+    {
+        throw std::runtime_error("Unexpected end of columnar file");
+    }
+    return v;
+}
+
+}  // namespace detail
+
+/// Writes surface hits column by column in chunks of @c chunk_size rows.
+///
+/// File layout: magic, version, then a sequence of chunks. A chunk starts with
+/// its number of rows, followed by every column as (column id, encoding, byte
+/// size, payload). The byte size lets a reader skip the columns it does not
+/// need. A chunk with zero rows terminates the file.
+///
+/// Fixed size fields are written in host byte order. A file from a host with
+/// the other byte order fails the version check of the reader.
+///
+/// Write errors throw from @c flush and @c close. The destructor closes the
+/// file as well, but has to swallow errors: call @c close explicitly.
+class columnar_writer
+{
+    public:
+    explicit columnar_writer(const std::string &file_name,
+                             const std::size_t chunk_size = 1 << 16)
+        : _file_name(file_name), _chunk_size(chunk_size)
+    {
+        // The row count of a chunk is written as 32 bit integer
+        if (chunk_size == 0 or
+            chunk_size > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw std::invalid_argument(
+                "Chunk size must be in [1, 2^32 - 1], got " +
+                std::to_string(chunk_size));
+        }
+        _out.open(file_name, std::ios::binary);
+        if (not _out)
+        {
+            throw std::runtime_error("Cannot open " + file_name);
+        }
+        _out.write(detail::file_magic, sizeof(detail::file_magic));
+        _out.write(reinterpret_cast<const char *>(&detail::file_version),
+                   sizeof(detail::file_version));
+        check_stream();
+        _rows.reserve(_chunk_size);
+    }
+
+    ~columnar_writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (const std::exception &)
+        {
+            // Destructors must not throw, the file is incomplete
+        }
+    }
+
+    columnar_writer(const columnar_writer &) = delete;
+    columnar_writer &operator=(const columnar_writer &) = delete;
+
+    void write(const surface_hit &hit)
+    {
+        _rows.push_back(hit);
+        if (_rows.size() == _chunk_size)
+        {
+            flush();
+        }
+    }
+
+    /// Encode and write the buffered rows as one chunk
+    void flush()
+    {
+        if (_rows.empty())
+        {
+            return;
+        }
+
+        put_header(static_cast<std::uint32_t>(_rows.size()));
+
+        encode_delta(column::e_track_id,
+                     [](const surface_hit &h) { return h.track_id; });
+        encode_dictionary(column::e_volume_id,
+                          [](const surface_hit &h) { return h.volume_id; });
+        encode_delta(column::e_surface_id,
+                     [](const surface_hit &h) { return h.surface_id; });
+        encode_float(column::e_path,
+                     [](const surface_hit &h) { return h.path; });
+        encode_float(column::e_loc0,
+                     [](const surface_hit &h) { return h.local[0]; });
+        encode_float(column::e_loc1,
+                     [](const surface_hit &h) { return h.local[1]; });
+        encode_float(column::e_dir_x,
+                     [](const surface_hit &h) { return h.dir[0]; });
+        encode_float(column::e_dir_y,
+                     [](const surface_hit &h) { return h.dir[1]; });
+        encode_float(column::e_dir_z,
+                     [](const surface_hit &h) { return h.dir[2]; });
+
+        _rows.clear();
+        check_stream();
+    }
+
+    /// Flush, write the end marker and close the file
+    void close()
+    {
+        if (not _out.is_open())
+        {
+            return;
+        }
+        flush();
+        put_header(0);
+        _out.close();
+        check_stream();
+    }
+
+    private:
+    /// Throw if a write to (or closing) the file failed
+    void check_stream() const
+    {
+        if (not _out)
+        {
+            throw std::runtime_error("Error writing " + _file_name);
+        }
+    }
+
+    void put_header(const std::uint32_t n_rows)
+    {
+        _out.write(reinterpret_cast<const char *>(&n_rows), sizeof(n_rows));
+    }
+
+    void put_column(const column col, const encoding enc)
+    {
+        const std::uint8_t ids[2] = {static_cast<std::uint8_t>(col),
+                                     static_cast<std::uint8_t>(enc)};
+        const auto n_bytes = static_cast<std::uint32_t>(_buf.size());
+        _out.write(reinterpret_cast<const char *>(ids), sizeof(ids));
+        _out.write(reinterpret_cast<const char *>(&n_bytes), sizeof(n_bytes));
+        _out.write(_buf.data(), static_cast<std::streamsize>(_buf.size()));
+    }
+
+    template <typename getter_t>
+    void encode_delta(const column col, getter_t &&get)
+    {
+        _buf.clear();
+        std::int64_t prev{0};
+        for (const auto &row : _rows)
+        {
+            const auto v = static_cast<std::int64_t>(get(row));
+            detail::put_varint(_buf, detail::zigzag(v - prev));
+            prev = v;
+        }
+        put_column(col, encoding::e_delta_varint);
+    }
+
+    template <typename getter_t>
+    void encode_dictionary(const column col, getter_t &&get)
+    {
+        _buf.clear();
+        _dict.clear();
+        _dict_values.clear();
+        _codes.clear();
+        for (const auto &row : _rows)
+        {
+            const std::uint64_t v = get(row);
+            auto [itr, inserted] = _dict.try_emplace(v, _dict_values.size());
+            if (inserted)
+            {
+                _dict_values.push_back(v);
+            }
+            _codes.push_back(itr->second);
+        }
+
+        detail::put_varint(_buf, _dict_values.size());
+        for (const auto v : _dict_values)
+        {
+            detail::put_varint(_buf, v);
+        }
+        for (const auto c : _codes)
+        {
+            detail::put_varint(_buf, c);
+        }
+        put_column(col, encoding::e_dictionary);
+    }
+
+    template <typename getter_t>
+    void encode_float(const column col, getter_t &&get)
+    {
+        _buf.clear();
+        _buf.reserve(_rows.size() * sizeof(float));
+        for (const auto &row : _rows)
+        {
+            detail::put_raw(_buf, static_cast<float>(get(row)));
+        }
+        put_column(col, encoding::e_plain_float);
+    }
+
+    std::string _file_name;
+    std::ofstream _out;
+    std::size_t _chunk_size;
+    std::vector<surface_hit> _rows{};
+
+    // Scratch space, kept between chunks
+    std::vector<char> _buf{};
+    std::unordered_map<std::uint64_t, std::uint64_t> _dict{};
+    std::vector<std::uint64_t> _dict_values{};
+    std::vector<std::uint64_t> _codes{};
+};
+
+/// Reads a file written by the @c columnar_writer, either single columns or
+/// complete rows.
+class columnar_reader
+{
+    public:
+    explicit columnar_reader(const std::string &file_name)
+        : _file_name(file_name)
+    {
+        // Fail early on files that are not in the columnar format
+        open();
+    }
+
+    /// Read a column that holds ids (track, volume or surface)
+    std::vector<std::uint64_t> read_ids(const column col) const
+    {
+        std::vector<std::uint64_t> values;
+        for_each_chunk(col, [&values](const encoding enc, const char *ptr,
+                                      const char *end, const std::size_t n) {
+            if (enc == encoding::e_delta_varint)
+            {
+                std::int64_t prev{0};
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    prev += detail::unzigzag(detail::get_varint(ptr, end));
+                    values.push_back(static_cast<std::uint64_t>(prev));
+                }
+            }
+            else if (enc == encoding::e_dictionary)
+            {
+                std::vector<std::uint64_t> dict(detail::get_varint(ptr, end));
+                for (auto &v : dict)
+                {
+                    v = detail::get_varint(ptr, end);
+                }
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    values.push_back(dict.at(detail::get_varint(ptr, end)));
+                }
+            }
+            else
+            {
+                throw std::runtime_error("Not an id column");
+            }
+        });
+        return values;
+    }
+
+    /// Read a column that holds floats
+    std::vector<float> read_floats(const column col) const
+    {
+        std::vector<float> values;
+        for_each_chunk(col, [&values](const encoding enc, const char *ptr,
+                                      const char *end, const std::size_t n) {
+            if (enc != encoding::e_plain_float or
+                end - ptr != static_cast<std::ptrdiff_t>(n * sizeof(float)))
+            {
+                throw std::runtime_error("Not a float column");
+            }
+            const auto pos = values.size();
+            values.resize(pos + n);
+            std::memcpy(values.data() + pos, ptr, n * sizeof(float));
+        });
+        return values;
+    }
+
+    /// Read all columns and assemble the rows
+    std::vector<surface_hit> read_all() const
+    {
+        const auto track_ids = read_ids(column::e_track_id);
+        const auto volume_ids = read_ids(column::e_volume_id);
+        const auto surface_ids = read_ids(column::e_surface_id);
+        const auto path = read_floats(column::e_path);
+        const auto loc0 = read_floats(column::e_loc0);
+        const auto loc1 = read_floats(column::e_loc1);
+        const auto dir_x = read_floats(column::e_dir_x);
+        const auto dir_y = read_floats(column::e_dir_y);
+        const auto dir_z = read_floats(column::e_dir_z);
+
+        std::vector<surface_hit> hits(track_ids.size());
+        for (std::size_t i = 0; i < hits.size(); ++i)
+        {
+            hits[i] = {track_ids[i],
+                       static_cast<std::uint32_t>(volume_ids[i]),
+                       static_cast<std::uint32_t>(surface_ids[i]),
+                       path[i],
+                       {loc0[i], loc1[i]},
+                       {dir_x[i], dir_y[i], dir_z[i]}};
+        }
+        return hits;
+    }
+
+    private:
+    /// Open the file and check the header
+    std::ifstream open() const
+    {
+        std::ifstream in(_file_name, std::ios::binary);
+        if (not in)
+        {
+            throw std::runtime_error("Cannot open " + _file_name);
+        }
+        char magic[sizeof(detail::file_magic)];
+        in.read(magic, sizeof(magic));
+        if (not in or
+            std::memcmp(magic, detail::file_magic, sizeof(magic)) != 0 or
+            detail::get_raw<std::uint32_t>(in) != detail::file_version)
+        {
+            throw std::runtime_error(_file_name + " is not a columnar file");
+        }
+        return in;
+    }
+
+    /// Call @param decode on the payload of @param col in every chunk, seeking
+    /// over all other columns
+    template <typename decoder_t>
+    void for_each_chunk(const column col, decoder_t &&decode) const
+    {
+        std::ifstream in = open();
+        std::vector<char> payload;
+
+        while (const auto n_rows = detail::get_raw<std::uint32_t>(in))
+        {
+            for (std::size_t c = 0;
+                 c < static_cast<std::size_t>(column::e_n_columns); ++c)
+            {
+                const auto id = detail::get_raw<std::uint8_t>(in);
+                const auto enc = detail::get_raw<std::uint8_t>(in);
+                const auto n_bytes = detail::get_raw<std::uint32_t>(in);
+
+                if (id != static_cast<std::uint8_t>(col))
+                {
+                    in.seekg(n_bytes, std::ios::cur);
+                    continue;
+                }
+
+                payload.resize(n_bytes);
+                if (not in.read(payload.data(), n_bytes))
+                {
+                    throw std::runtime_error("Truncated column chunk");
+                }
+                decode(static_cast<encoding>(enc), payload.data(),
+                       payload.data() + payload.size(), n_rows);
+            }
+        }
+    }
+
+    std::string _file_name;
+};
+
+}  // namespace detray::tutorial
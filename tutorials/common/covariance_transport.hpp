@@ -0,0 +1,537 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// Detray include(s).
+#include "detray/propagator/actor_chain.hpp"
+#include "detray/propagator/base_actor.hpp"
+#include "detray/propagator/navigator.hpp"
+#include "detray/propagator/propagator.hpp"
+#include "detray/propagator/rk_stepper.hpp"
+
+// Project include(s).
+#include "propagation_loop.hpp"
+#include "step_size.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace detray::tutorial {
+
+/// Free parameter vector: (x, y, z, t, tx, ty, tz, q/p)
+constexpr std::size_t e_free_size = 8;
+
+/// Batch of N x N matrices, one per lane.
+///
+/// The lane index runs fastest, so every element-wise loop over the lanes is
+/// a contiguous loop the compiler can vectorize. A batch with a single lane is
+/// the plain per-track matrix.
+template <std::size_t N, std::size_t W>
+struct matrix_batch
+{
+    static constexpr std::size_t size = N;
+    static constexpr std::size_t width = W;
+
+    alignas(64) std::array<std::array<std::array<scalar, W>, N>, N> m;
+
+    static matrix_batch identity()
+    {
+        matrix_batch batch;
+        for (std::size_t l = 0; l < W; ++l)
+        {
+            batch.set_identity(l);
+        }
+        return batch;
+    }
+
+    void set_identity(const std::size_t lane)
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                m[i][j][lane] = (i == j) ? 1. : 0.;
+            }
+        }
+    }
+};
+
+/// Free covariance or Jacobian of a single track
+using free_matrix = matrix_batch<e_free_size, 1>;
+
+/// Copy lane @param src_lane of @param src into lane @param dst_lane of
+/// @param dst
+template <std::size_t N, std::size_t W_src, std::size_t W_dst>
+inline void copy_lane(const matrix_batch<N, W_src> &src,
+                      const std::size_t src_lane, matrix_batch<N, W_dst> &dst,
+                      const std::size_t dst_lane)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = 0; j < N; ++j)
+        {
+            dst.m[i][j][dst_lane] = src.m[i][j][src_lane];
+        }
+    }
+}
+
+/// C = J * C * J^T for every lane of the batch, using @param tmp as scratch
+template <std::size_t N, std::size_t W>
+inline void transport_covariance(const matrix_batch<N, W> &J,
+                                 matrix_batch<N, W> &C,
+                                 matrix_batch<N, W> &tmp)
+{
+    // tmp = J * C
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            std::array<scalar, W> acc{};
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                for (std::size_t l = 0; l < W; ++l)
+                {
+                    acc[l] += J.m[i][j][l] * C.m[j][k][l];
+                }
+            }
+            tmp.m[i][k] = acc;
+        }
+    }
+
+    // C = tmp * J^T, only the upper triangle is computed
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t k = i; k < N; ++k)
+        {
+            std::array<scalar, W> acc{};
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                for (std::size_t l = 0; l < W; ++l)
+                {
+                    acc[l] += tmp.m[i][j][l] * J.m[k][j][l];
+                }
+            }
+            C.m[i][k] = acc;
+            C.m[k][i] = acc;
+        }
+    }
+}
+
+namespace rk_math {
+
+using vec3 = std::array<scalar, 3>;
+
+/// f * (a x b)
+inline vec3 scaled_cross(const scalar f, const vec3 &a, const vec3 &b)
+{
+    return {f * (a[1] * b[2] - a[2] * b[1]), f * (a[2] * b[0] - a[0] * b[2]),
+            f * (a[0] * b[1] - a[1] * b[0])};
+}
+
+/// a + f * b
+inline vec3 add_scaled(const vec3 &a, const scalar f, const vec3 &b)
+{
+    return {a[0] + f * b[0], a[1] + f * b[1], a[2] + f * b[2]};
+}
+
+}  // namespace rk_math
+
+/// Field values and derivatives k = d^2 pos / ds^2 of the four stages of a
+/// Runge-Kutta-Nystroem step
+struct rk_stage_data
+{
+    rk_math::vec3 b_first, b_middle, b_last;
+    rk_math::vec3 k1, k2, k3, k4;
+};
+
+/// Evaluate the stages of a step of length @param h from @param pos along
+/// @param dir. @c b_first has to be set already, the other field values are
+/// taken from @param get_field.
+///
+/// @returns the estimate of the local integration error
+template <typename field_getter_t>
+inline scalar rk_stages(rk_stage_data &sd, const rk_math::vec3 &pos,
+                        const rk_math::vec3 &dir, const scalar qop,
+                        const scalar h, field_getter_t &&get_field)
+{
+    using rk_math::add_scaled;
+    using rk_math::scaled_cross;
+
+    const scalar half_h = 0.5 * h;
+    const scalar h2 = h * h;
+
+    sd.k1 = scaled_cross(qop, dir, sd.b_first);
+
+    // Middle of the step
+    sd.b_middle = get_field(
+        add_scaled(add_scaled(pos, half_h, dir), 0.125 * h2, sd.k1));
+    sd.k2 = scaled_cross(qop, add_scaled(dir, half_h, sd.k1), sd.b_middle);
+    sd.k3 = scaled_cross(qop, add_scaled(dir, half_h, sd.k2), sd.b_middle);
+
+    // End of the step
+    sd.b_last =
+        get_field(add_scaled(add_scaled(pos, h, dir), 0.5 * h2, sd.k3));
+    sd.k4 = scaled_cross(qop, add_scaled(dir, h, sd.k3), sd.b_last);
+
+    scalar err2{0.};
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        const scalar e = h2 * (sd.k1[i] - sd.k2[i] - sd.k3[i] + sd.k4[i]);
+        err2 += e * e;
+    }
+    return std::sqrt(err2);
+}
+
+/// Position and direction at the end of the step @param h of which
+/// @param sd holds the stages
+inline void rk_advance(const rk_stage_data &sd, const scalar h,
+                       rk_math::vec3 &pos, rk_math::vec3 &dir)
+{
+    scalar norm2{0.};
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        pos[i] += h * dir[i] + h * h / 6. * (sd.k1[i] + sd.k2[i] + sd.k3[i]);
+        dir[i] += h / 6. * (sd.k1[i] + 2. * (sd.k2[i] + sd.k3[i]) + sd.k4[i]);
+        norm2 += dir[i] * dir[i];
+    }
+    const scalar inv_norm = 1. / std::sqrt(norm2);
+    for (auto &d : dir)
+    {
+        d *= inv_norm;
+    }
+}
+
+/// Fill lane @param lane of @param J with the free transport Jacobian of a
+/// Runge-Kutta-Nystroem step of length @param h, starting along
+/// @param dir, from the derivatives of its stages.
+///
+/// The field is taken from the stages, so the Jacobian follows the field the
+/// track actually saw; only the derivatives of the field itself are
+/// neglected. Time and q/p are left untouched (no mass, no material).
+template <std::size_t W>
+inline void rk_transport_jacobian(matrix_batch<e_free_size, W> &J,
+                                  const std::size_t lane,
+                                  const rk_stage_data &sd,
+                                  const rk_math::vec3 &dir, const scalar qop,
+                                  const scalar h)
+{
+    using rk_math::add_scaled;
+    using rk_math::scaled_cross;
+    using rk_math::vec3;
+
+    const scalar half_h = 0.5 * h;
+
+    J.set_identity(lane);
+
+    // Derivatives of the stages by the direction, one column at a time
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+        vec3 e_j{0., 0., 0.};
+        e_j[j] = 1.;
+
+        const vec3 dk1 = scaled_cross(qop, e_j, sd.b_first);
+        const vec3 dk2 =
+            scaled_cross(qop, add_scaled(e_j, half_h, dk1), sd.b_middle);
+        const vec3 dk3 =
+            scaled_cross(qop, add_scaled(e_j, half_h, dk2), sd.b_middle);
+        const vec3 dk4 = scaled_cross(qop, add_scaled(e_j, h, dk3), sd.b_last);
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            // d pos / d dir
+            J.m[i][4 + j][lane] = h * e_j[i] + h * h / 6. *
+                                                   (dk1[i] + dk2[i] + dk3[i]);
+            // d dir / d dir
+            J.m[4 + i][4 + j][lane] +=
+                h / 6. * (dk1[i] + 2. * (dk2[i] + dk3[i]) + dk4[i]);
+        }
+    }
+
+    // Derivatives of the stages by q/p
+    const vec3 dk1 = scaled_cross(1., dir, sd.b_first);
+    const vec3 dk2 =
+        add_scaled(scaled_cross(1., add_scaled(dir, half_h, sd.k1),
+                                sd.b_middle),
+                   qop * half_h, scaled_cross(1., dk1, sd.b_middle));
+    const vec3 dk3 =
+        add_scaled(scaled_cross(1., add_scaled(dir, half_h, sd.k2),
+                                sd.b_middle),
+                   qop * half_h, scaled_cross(1., dk2, sd.b_middle));
+    const vec3 dk4 = add_scaled(
+        scaled_cross(1., add_scaled(dir, h, sd.k3), sd.b_last), qop * h,
+        scaled_cross(1., dk3, sd.b_last));
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        // d pos / d qop
+        J.m[i][7][lane] = h * h / 6. * (dk1[i] + dk2[i] + dk3[i]);
+        // d dir / d qop
+        J.m[4 + i][7][lane] =
+            h / 6. * (dk1[i] + 2. * (dk2[i] + dk3[i]) + dk4[i]);
+    }
+}
+
+/// What a step of the @c covariant_rk_stepper computes besides the track
+enum class transport_mode : std::uint8_t
+{
+    e_none = 0,       ///< nothing, the bare RKN step
+    e_jacobian = 1,   ///< the step Jacobian
+    e_covariance = 2  ///< the step Jacobian and the transported covariance
+};
+
+/// Runge-Kutta stepper that transports the free covariance of the track.
+///
+/// Every step computes the transport Jacobian of that step from the
+/// derivatives of its Runge-Kutta stages and, depending on the transport mode
+/// of the state, applies it to the covariance right away. Jacobian and
+/// covariance are therefore valid at every point of the propagation, in
+/// particular on the surfaces the actors see. The step itself follows the
+/// adaptive Runge-Kutta-Nystroem scheme of @c rk_stepper, with the error
+/// tolerance of its state. With @c transport_mode::e_none it is the baseline
+/// for the cost of the transport.
+template <typename magnetic_field_t, typename track_t,
+          typename constraint_t = unconstrained_step,
+          typename policy_t = stepper_default_policy>
+class covariant_rk_stepper
+    : public rk_stepper<magnetic_field_t, track_t, constraint_t, policy_t>
+{
+    using base_type =
+        rk_stepper<magnetic_field_t, track_t, constraint_t, policy_t>;
+    using base_state = typename base_type::state;
+
+    public:
+    struct state : public base_state
+    {
+        using base_state::base_state;
+
+        /// Free transport Jacobian of the last step
+        free_matrix step_jacobian = free_matrix::identity();
+        /// Free covariance of the track
+        free_matrix covariance = free_matrix::identity();
+        /// What every step computes. A lockstep batch only takes the
+        /// Jacobians and transports the covariances of all its tracks at once.
+        transport_mode mode{transport_mode::e_covariance};
+    };
+
+    covariant_rk_stepper(const magnetic_field_t mag_field)
+        : base_type(mag_field), _magnetic_field(mag_field)
+    {
+    }
+
+    /// Take a step to the next navigation candidate (or to the constraint)
+    /// and transport the covariance along
+    template <typename propagation_state_t>
+    bool step(propagation_state_t &propagation)
+    {
+        state &stepping = propagation._stepping;
+        auto &navigation = propagation._navigation;
+        auto &track = stepping._track;
+
+        // Distance to the next candidate, within the constraints
+        set_step_to_next_candidate(stepping, navigation);
+
+        const auto track_pos = track.pos();
+        const auto track_dir = track.dir();
+        rk_math::vec3 pos{track_pos[0], track_pos[1], track_pos[2]};
+        rk_math::vec3 dir{track_dir[0], track_dir[1], track_dir[2]};
+        const rk_math::vec3 start_dir = dir;
+        const scalar qop = track.qop();
+
+        const auto get_field = [this](const rk_math::vec3 &p) {
+            const auto b = _magnetic_field.get_field(
+                point3{p[0], p[1], p[2]},
+                typename magnetic_field_t::context_type{});
+            return rk_math::vec3{b[0], b[1], b[2]};
+        };
+
+        // Shrink the step until the integration error is small enough
+        rk_stage_data sd;
+        sd.b_first = get_field(pos);
+        scalar h = stepping.step_size();
+        scalar error = rk_stages(sd, pos, dir, qop, h, get_field);
+        for (std::size_t n_trials = 0; error > stepping._tolerance; ++n_trials)
+        {
+            if (n_trials == max_trials)
+            {
+                return false;
+            }
+            const scalar scale = std::pow(
+                stepping._tolerance / (scalar{2.} * error), scalar{0.25});
+            h *= std::min(std::max(scalar{0.25}, scale), scalar{4.});
+            error = rk_stages(sd, pos, dir, qop, h, get_field);
+        }
+        stepping.set_step_size(h);
+
+        // Advance the track
+        rk_advance(sd, h, pos, dir);
+        track.set_pos(point3{pos[0], pos[1], pos[2]});
+        track.set_dir(vector3{dir[0], dir[1], dir[2]});
+        stepping._path_length += h;
+
+        // Transport
+        if (stepping.mode != transport_mode::e_none)
+        {
+            rk_transport_jacobian(stepping.step_jacobian, 0, sd, start_dir,
+                                  qop, h);
+        }
+        if (stepping.mode == transport_mode::e_covariance)
+        {
+            free_matrix tmp;
+            transport_covariance(stepping.step_jacobian, stepping.covariance,
+                                 tmp);
+        }
+
+        // Call navigation update policy
+        policy_t{}(stepping.policy_state(), propagation);
+
+        return true;
+    }
+
+    private:
+    static constexpr std::size_t max_trials{100};
+
+    magnetic_field_t _magnetic_field;
+};
+
+/// Runs the loop of @c propagator::propagate for @c W tracks in lockstep on
+/// one thread, with a @c covariant_rk_stepper.
+///
+/// All lanes take their step, then the covariances of all lanes are
+/// transported with a single call of the batched kernel, and only then the
+/// navigation is updated and the actors run. The actors therefore see the
+/// transported covariance, as with the per-track transport. A finished lane
+/// is refilled with the next track right away.
+template <std::size_t W, typename stepper_t, typename detector_t,
+          typename actor_chain_t = actor_chain<>>
+class lockstep_propagator
+{
+    public:
+    using navigator_type = navigator<detector_t>;
+    using propagator_type =
+        propagator<stepper_t, navigator_type, actor_chain_t>;
+    using state = typename propagator_type::state;
+    using batch_type = matrix_batch<e_free_size, W>;
+
+    lockstep_propagator(stepper_t &&s, const detector_t &det)
+        : _stepper(std::move(s)), _navigator(det)
+    {
+    }
+
+    /// Propagate all @param tracks, starting from the covariance
+    /// @param initial_cov.
+    ///
+    /// @param actor_states returns the actor states of a track from its index
+    ///
+    /// @returns the number of successfully propagated tracks
+    template <typename track_t, typename actor_states_fn_t>
+    std::size_t propagate(const std::vector<track_t> &tracks,
+                          const free_matrix &initial_cov,
+                          actor_states_fn_t &&actor_states)
+    {
+        std::array<std::optional<state>, W> lanes;
+        batch_type J = batch_type::identity();
+        batch_type C = batch_type::identity();
+        batch_type tmp;
+
+        std::size_t n_started{0};
+        std::size_t n_success{0};
+        std::size_t n_active{0};
+
+        const auto emplace_state = [&](std::optional<state> &lane,
+                                       const std::size_t trk) -> state & {
+            state &propagation = lane.emplace(tracks[trk], actor_states(trk));
+            propagation._stepping.mode = transport_mode::e_jacobian;
+            propagation._stepping.covariance = initial_cov;
+            return propagation;
+        };
+        const auto refill = [&](const std::size_t l) {
+            if (refill_slot(lanes[l], tracks.size(), n_started, n_success,
+                            _navigator, _actor_chain, emplace_state))
+            {
+                copy_lane(initial_cov, 0, C, l);
+            }
+        };
+
+        for (std::size_t l = 0; l < W; ++l)
+        {
+            refill(l);
+            n_active += lanes[l].has_value();
+        }
+
+        while (n_active > 0)
+        {
+            // Step all lanes and collect their step Jacobians
+            for (std::size_t l = 0; l < W; ++l)
+            {
+                if (lanes[l].has_value())
+                {
+                    step_track(*lanes[l], _stepper);
+                    copy_lane(lanes[l]->_stepping.step_jacobian, 0, J, l);
+                }
+                else
+                {
+                    J.set_identity(l);
+                }
+            }
+
+            transport_covariance(J, C, tmp);
+
+            // Hand the covariances back, then navigate and run the actors
+            for (std::size_t l = 0; l < W; ++l)
+            {
+                if (not lanes[l].has_value())
+                {
+                    continue;
+                }
+
+                state &propagation = *lanes[l];
+                copy_lane(C, l, propagation._stepping.covariance, 0);
+                if (update_track(propagation, _navigator, _actor_chain))
+                {
+                    continue;
+                }
+
+                // Track finished: replace it by the next one
+                n_success += propagation._navigation.is_complete();
+                refill(l);
+                n_active -= not lanes[l].has_value();
+            }
+        }
+
+        return n_success;
+    }
+
+    private:
+    stepper_t _stepper;
+    navigator_type _navigator;
+    actor_chain_t _actor_chain{};
+};
+
+/// Actor that records the covariance of the track on every module
+struct covariance_recorder : actor
+{
+    struct state
+    {
+        std::vector<free_matrix> on_modules{};
+    };
+
+    template <typename propagator_state_t>
+    void operator()(state &recorder_state,
+                    const propagator_state_t &prop_state) const
+    {
+        if (prop_state._navigation.is_on_module())
+        {
+            recorder_state.on_modules.push_back(
+                prop_state._stepping.covariance);
+        }
+    }
+};
+
+}  // namespace detray::tutorial
@@ -0,0 +1,96 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// Detray include(s).
+#include "detray/field/constant_magnetic_field.hpp"
+#include "detray/intersection/detail/trajectories.hpp"
+#include "detray/propagator/rk_stepper.hpp"
+
+// Project include(s).
+#include "step_size.hpp"
+
+// System include(s).
+#include <type_traits>
+
+namespace detray::tutorial {
+
+/// Whether @c field_t is a @c constant_magnetic_field
+template <typename field_t>
+struct is_constant_field : std::false_type
+{
+};
+
+template <typename... Ts>
+struct is_constant_field<constant_magnetic_field<Ts...>> : std::true_type
+{
+};
+
+/// Stepper that advances the track on the analytic helix.
+///
+/// In a constant magnetic field without material the helix is the exact
+/// solution of the equation of motion, so the step can go straight to the next
+/// navigation candidate: no Runge-Kutta stages and no step size adaption. The
+/// stepper state is the one of the RK stepper, which makes this a drop-in
+/// replacement for @c rk_stepper in the @c propagator. Step constraints set on
+/// the state are still respected. In a vanishing field the track moves on a
+/// straight line.
+template <typename magnetic_field_t, typename track_t,
+          typename constraint_t = unconstrained_step,
+          typename policy_t = stepper_default_policy>
+class helix_stepper
+    : public rk_stepper<magnetic_field_t, track_t, constraint_t, policy_t>
+{
+    using base_type =
+        rk_stepper<magnetic_field_t, track_t, constraint_t, policy_t>;
+
+    static_assert(is_constant_field<magnetic_field_t>::value,
+                  "The helix is only the exact trajectory in a constant field");
+
+    public:
+    using state = typename base_type::state;
+
+    helix_stepper(const magnetic_field_t mag_field)
+        : base_type(mag_field), _magnetic_field(mag_field)
+    {
+    }
+
+    /// Take a step to the next navigation candidate (or to the constraint)
+    template <typename propagation_state_t>
+    bool step(propagation_state_t &propagation)
+    {
+        state &stepping = propagation._stepping;
+        auto &navigation = propagation._navigation;
+        auto &track = stepping._track;
+
+        // Distance to the next candidate, within the constraints
+        set_step_to_next_candidate(stepping, navigation);
+
+        // Advance the track along the helix, the helix is undefined for B = 0
+        const auto B = _magnetic_field.get_field(
+            track.pos(), typename magnetic_field_t::context_type{});
+        const scalar h = stepping.step_size();
+
+        if (B[0] == 0. and B[1] == 0. and B[2] == 0.)
+        {
+            track.set_pos(track.pos() + h * track.dir());
+        }
+        else
+        {
+            const detail::helix hlx(track, &B);
+            track.set_pos(hlx.pos(h));
+            track.set_dir(hlx.dir(h));
+        }
+        stepping._path_length += h;
+
+        // Call navigation update policy
+        policy_t{}(stepping.policy_state(), propagation);
+
+        return true;
+    }
+
+    private:
+    magnetic_field_t _magnetic_field;
+};
+
+}  // namespace detray::tutorial
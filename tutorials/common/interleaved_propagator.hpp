@@ -0,0 +1,163 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// Detray include(s).
+#include "detray/definitions/indexing.hpp"
+#include "detray/propagator/actor_chain.hpp"
+#include "detray/propagator/navigator.hpp"
+#include "detray/propagator/propagator.hpp"
+
+// Project include(s).
+#include "propagation_loop.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace detray::tutorial {
+
+/// Mask store functor: pull the transform and the masks of a surface into the
+/// cache without touching them
+struct prefetch_surface
+{
+    using output_type = bool;
+
+    template <typename mask_group_t, typename surface_t,
+              typename transform_store_t>
+    inline output_type operator()(
+        const mask_group_t &mask_group, const surface_t &surface,
+        const transform_store_t &contextual_transforms) const
+    {
+        __builtin_prefetch(&contextual_transforms[surface.transform()]);
+        for (const auto &mask : range(mask_group, surface.mask_range()))
+        {
+            __builtin_prefetch(&mask);
+        }
+        return true;
+    }
+};
+
+/// Runs the loop of @c propagator::propagate for several tracks on one thread.
+///
+/// Every track in flight owns a slot with its propagator state. The slots are
+/// advanced by one step (stepper, navigator, actors) in round-robin, and after
+/// each step the data of the next navigation candidates is prefetched, so
+/// that it has arrived by the time the slot is visited again.
+template <typename stepper_t, typename detector_t,
+          typename actor_chain_t = actor_chain<>>
+class interleaved_propagator
+{
+    public:
+    using navigator_type = navigator<detector_t>;
+    using propagator_type =
+        propagator<stepper_t, navigator_type, actor_chain_t>;
+    using state = typename propagator_type::state;
+
+    interleaved_propagator(stepper_t &&s, const detector_t &det)
+        : _stepper(std::move(s)), _navigator(det), _detector(&det)
+    {
+    }
+
+    /// Propagate all @param tracks with @param n_interleave of them in flight.
+    ///
+    /// @param prefetch issue prefetches before switching to the next track
+    ///
+    /// @returns the number of successfully propagated tracks
+    template <typename track_t>
+    std::size_t propagate(const std::vector<track_t> &tracks,
+                          const std::size_t n_interleave,
+                          const bool prefetch = true)
+    {
+        std::vector<std::optional<state>> slots(
+            std::max<std::size_t>(n_interleave, 1));
+
+        std::size_t n_started{0};
+        std::size_t n_success{0};
+
+        // Fill the slots with the first tracks
+        for (auto &slot : slots)
+        {
+            refill(slot, tracks, n_started, n_success);
+        }
+
+        std::size_t n_active{0};
+        for (const auto &slot : slots)
+        {
+            n_active += slot.has_value();
+        }
+
+        // Round-robin over the slots until all tracks are done
+        while (n_active > 0)
+        {
+            for (auto &slot : slots)
+            {
+                if (not slot.has_value())
+                {
+                    continue;
+                }
+
+                state &propagation = *slot;
+                if (propagation_step(propagation, _stepper, _navigator,
+                                     _actor_chain))
+                {
+                    if (prefetch)
+                    {
+                        prefetch_next(propagation);
+                    }
+                    continue;
+                }
+
+                // Track finished: replace it by the next one
+                n_success += propagation._navigation.is_complete();
+                refill(slot, tracks, n_started, n_success);
+                n_active -= not slot.has_value();
+            }
+        }
+
+        return n_success;
+    }
+
+    private:
+    /// Put the next track into @param slot, see @c refill_slot
+    template <typename track_t>
+    void refill(std::optional<state> &slot, const std::vector<track_t> &tracks,
+                std::size_t &n_started, std::size_t &n_success)
+    {
+        refill_slot(slot, tracks.size(), n_started, n_success, _navigator,
+                    _actor_chain,
+                    [&tracks](std::optional<state> &s,
+                              const std::size_t trk) -> state & {
+                        return s.emplace(tracks[trk]);
+                    });
+    }
+
+    /// Prefetch the surface data the next steps of this track will need.
+    ///
+    /// The update has just intersected the next candidate, so its data is
+    /// most likely still cached. The candidate after it is only needed once
+    /// the track reaches the next one, and is the one that can be cold.
+    void prefetch_next(const state &propagation) const
+    {
+        const auto &navigation = propagation._navigation;
+        const auto end = navigation.candidates().end();
+
+        auto itr = navigation.next();
+        for (std::size_t i = 0; i < 2 and itr != end; ++i, ++itr)
+        {
+            const auto &sf = _detector->surfaces()[itr->index];
+            _detector->mask_store().template execute<prefetch_surface>(
+                sf.mask_type(), sf, _detector->transform_store());
+        }
+    }
+
+    stepper_t _stepper;
+    navigator_type _navigator;
+    actor_chain_t _actor_chain{};
+    const detector_t *_detector;
+};
+
+}  // namespace detray::tutorial
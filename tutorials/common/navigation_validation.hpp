@@ -0,0 +1,91 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// Detray include(s).
+#include "detray/definitions/indexing.hpp"
+#include "detray/intersection/detail/trajectories.hpp"
+#include "detray/propagator/base_actor.hpp"
+#include "tests/common/tools/particle_gun.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace detray::tutorial {
+
+/// Actor that counts the steps and records every module the navigator
+/// reaches: its surface index and the path length and position of the track
+struct module_recorder : actor
+{
+    struct state
+    {
+        std::size_t n_calls{0};
+        std::vector<dindex> modules{};
+        std::vector<scalar> paths{};
+        std::vector<point3> positions{};
+
+        /// Number of steps taken
+        std::size_t n_steps() const
+        {
+            // The first call comes from the navigation initialization
+            return n_calls > 0 ? n_calls - 1 : 0;
+        }
+    };
+
+    template <typename propagator_state_t>
+    void operator()(state &recorder_state,
+                    const propagator_state_t &prop_state) const
+    {
+        const auto &navigation = prop_state._navigation;
+        const auto &stepping = prop_state._stepping;
+
+        ++recorder_state.n_calls;
+        if (navigation.is_on_module())
+        {
+            recorder_state.modules.push_back(navigation.current()->index);
+            recorder_state.paths.push_back(stepping.path_length());
+            recorder_state.positions.push_back(stepping().pos());
+        }
+    }
+};
+
+/// Surface indices of the modules on the truth helix of @param track in the
+/// field @param B, in the order they are crossed
+template <typename detector_t, typename track_t>
+std::vector<dindex> truth_module_trace(const detector_t &det,
+                                       const track_t &track, const vector3 &B)
+{
+    const detail::helix helix(track, &B);
+    const auto intersection_trace = particle_gun::shoot_particle(det, helix);
+
+    std::vector<dindex> modules;
+    for (const auto &[volume, sfi] : intersection_trace)
+    {
+        // Modules link to their own volume, portals to the next one
+        if (sfi.link == volume)
+        {
+            modules.push_back(sfi.index);
+        }
+    }
+    return modules;
+}
+
+/// Number of @param truth modules that are also in @param found
+inline std::size_t n_found_modules(const std::vector<dindex> &truth,
+                                   std::vector<dindex> found)
+{
+    std::vector<dindex> sorted_truth(truth);
+    std::sort(sorted_truth.begin(), sorted_truth.end());
+    std::sort(found.begin(), found.end());
+
+    std::vector<dindex> common;
+    std::set_intersection(sorted_truth.begin(), sorted_truth.end(),
+                          found.begin(), found.end(),
+                          std::back_inserter(common));
+    return common.size();
+}
+
+}  // namespace detray::tutorial
@@ -0,0 +1,126 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace detray::tutorial {
+
+/// Phases of the loop in @c propagator::propagate
+enum class loop_phase : std::uint8_t
+{
+    e_navigator_init = 0,
+    e_stepper = 1,
+    e_navigator = 2,
+    e_actors = 3
+};
+
+/// Hook that is called after every phase and does nothing
+struct no_phase_hook
+{
+    void operator()(const loop_phase) const {}
+};
+
+/// Initialize the navigation and run the actors once, like
+/// @c propagator::propagate does before the first step.
+///
+/// @returns the heartbeat: if it is false, the track must not be stepped
+template <typename propagator_state_t, typename navigator_t,
+          typename actor_chain_t, typename hook_t = no_phase_hook>
+bool init_propagation(propagator_state_t &propagation, navigator_t &navigator,
+                      actor_chain_t &actor_chain, hook_t &&hook = {})
+{
+    propagation._heartbeat = navigator.init(propagation);
+    hook(loop_phase::e_navigator_init);
+
+    actor_chain(propagation._actor_states, propagation);
+    hook(loop_phase::e_actors);
+
+    return propagation._heartbeat;
+}
+
+/// First half of an iteration of the loop in @c propagator::propagate: the
+/// step.
+///
+/// @returns the heartbeat of the track
+template <typename propagator_state_t, typename stepper_t,
+          typename hook_t = no_phase_hook>
+bool step_track(propagator_state_t &propagation, stepper_t &stepper,
+                hook_t &&hook = {})
+{
+    propagation._heartbeat &= stepper.step(propagation);
+    hook(loop_phase::e_stepper);
+
+    return propagation._heartbeat;
+}
+
+/// Second half of an iteration of the loop in @c propagator::propagate:
+/// update the navigation and run the actors.
+///
+/// @returns the heartbeat of the track
+template <typename propagator_state_t, typename navigator_t,
+          typename actor_chain_t, typename hook_t = no_phase_hook>
+bool update_track(propagator_state_t &propagation, navigator_t &navigator,
+                  actor_chain_t &actor_chain, hook_t &&hook = {})
+{
+    propagation._heartbeat &= navigator.update(propagation);
+    hook(loop_phase::e_navigator);
+
+    actor_chain(propagation._actor_states, propagation);
+    hook(loop_phase::e_actors);
+
+    return propagation._heartbeat;
+}
+
+/// One iteration of the loop in @c propagator::propagate: step, update the
+/// navigation and run the actors.
+///
+/// @returns the heartbeat of the track
+template <typename propagator_state_t, typename stepper_t,
+          typename navigator_t, typename actor_chain_t,
+          typename hook_t = no_phase_hook>
+bool propagation_step(propagator_state_t &propagation, stepper_t &stepper,
+                      navigator_t &navigator, actor_chain_t &actor_chain,
+                      hook_t &&hook = {})
+{
+    step_track(propagation, stepper, hook);
+    return update_track(propagation, navigator, actor_chain, hook);
+}
+
+/// Put the next track that survives the navigation initialization into
+/// @param slot, or leave it empty if all @param n_tracks have been started.
+///
+/// A track whose heartbeat is dead after the initialization is finished right
+/// away, without a step, like in @c propagator::propagate.
+///
+/// @param n_started number of tracks taken so far, advanced here
+/// @param n_success number of successful tracks, advanced for dead tracks
+/// @param emplace_state emplaces the state of a track index into the slot
+///        and returns it
+///
+/// @returns whether the slot holds a track
+template <typename state_t, typename navigator_t, typename actor_chain_t,
+          typename emplace_fn_t>
+bool refill_slot(std::optional<state_t> &slot, const std::size_t n_tracks,
+                 std::size_t &n_started, std::size_t &n_success,
+                 navigator_t &navigator, actor_chain_t &actor_chain,
+                 emplace_fn_t &&emplace_state)
+{
+    slot.reset();
+    while (n_started < n_tracks)
+    {
+        state_t &propagation = emplace_state(slot, n_started++);
+        if (init_propagation(propagation, navigator, actor_chain))
+        {
+            return true;
+        }
+        n_success += propagation._navigation.is_complete();
+        slot.reset();
+    }
+    return false;
+}
+
+}  // namespace detray::tutorial
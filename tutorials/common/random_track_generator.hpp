@@ -0,0 +1,252 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// Detray include(s).
+#include "detray/definitions/units.hpp"
+
+// System include(s).
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace detray::tutorial {
+
+/// Philox4x32-10 counter-based random number generator.
+///
+/// Every (counter, key) pair maps to four independent random numbers, without
+/// any generator state. Any thread can therefore produce any element of the
+/// random sequence directly.
+class philox4x32
+{
+    public:
+    using counter_type = std::array<std::uint32_t, 4>;
+    using key_type = std::array<std::uint32_t, 2>;
+
+    static counter_type generate(counter_type ctr, key_type key)
+    {
+        for (int round = 0; round < 10; ++round)
+        {
+            const std::uint64_t prod0 =
+                static_cast<std::uint64_t>(mult_0) * ctr[0];
+            const std::uint64_t prod1 =
+                static_cast<std::uint64_t>(mult_1) * ctr[2];
+
+            ctr = {static_cast<std::uint32_t>(prod1 >> 32) ^ ctr[1] ^ key[0],
+                   static_cast<std::uint32_t>(prod1),
+                   static_cast<std::uint32_t>(prod0 >> 32) ^ ctr[3] ^ key[1],
+                   static_cast<std::uint32_t>(prod0)};
+
+            key[0] += weyl_0;
+            key[1] += weyl_1;
+        }
+        return ctr;
+    }
+
+    private:
+    static constexpr std::uint32_t mult_0 = 0xD2511F53;
+    static constexpr std::uint32_t mult_1 = 0xCD9E8D57;
+    static constexpr std::uint32_t weyl_0 = 0x9E3779B9;
+    static constexpr std::uint32_t weyl_1 = 0xBB67AE85;
+};
+
+/// Uniform in [0, 1) from a random word, with the 24 bits a float can hold
+inline scalar uniform(const std::uint32_t u)
+{
+    return static_cast<scalar>(u >> 8) * static_cast<scalar>(0x1.0p-24);
+}
+
+/// Four uniform numbers in [0, 1): element @param index of the random sequence
+/// of @param seed
+inline std::array<scalar, 4> uniform4(const std::uint64_t seed,
+                                      const std::uint64_t index)
+{
+    const auto rnd = philox4x32::generate(
+        {static_cast<std::uint32_t>(index),
+         static_cast<std::uint32_t>(index >> 32), 0, 0},
+        {static_cast<std::uint32_t>(seed),
+         static_cast<std::uint32_t>(seed >> 32)});
+    return {uniform(rnd[0]), uniform(rnd[1]), uniform(rnd[2]),
+            uniform(rnd[3])};
+}
+
+/// Random particle gun: momentum, direction, vertex and charge of track @c i
+/// are a pure function of the seed and @c i.
+///
+/// The output does not depend on which thread generates which track, so a
+/// parallel fill is bit-identical to the serial one for any thread count.
+template <typename track_t>
+class random_track_generator
+{
+    public:
+    struct configuration
+    {
+        std::uint64_t seed{42};
+        /// Momentum range, flat in p
+        scalar p_min{1. * unit_constants::GeV};
+        scalar p_max{10. * unit_constants::GeV};
+        /// Pseudorapidity and azimuth ranges, flat
+        scalar eta_min{-2.5};
+        scalar eta_max{2.5};
+        scalar phi_min{-M_PI};
+        scalar phi_max{M_PI};
+        /// Gaussian vertex smearing around the origin
+        std::array<scalar, 3> vertex_sigma{15. * unit_constants::um,
+                                           15. * unit_constants::um,
+                                           5. * unit_constants::cm};
+        /// Draw the charge at random, otherwise use @c charge
+        bool random_charge{true};
+        scalar charge{-1.};
+    };
+
+    random_track_generator() = default;
+
+    explicit random_track_generator(const configuration &cfg) : _cfg(cfg) {}
+
+    const configuration &config() const { return _cfg; }
+
+    /// Generate track number @param index of the sequence
+    track_t operator()(const std::uint64_t index) const
+    {
+        const philox4x32::key_type key{static_cast<std::uint32_t>(_cfg.seed),
+                                       static_cast<std::uint32_t>(
+                                           _cfg.seed >> 32)};
+        const auto lo = static_cast<std::uint32_t>(index);
+        const auto hi = static_cast<std::uint32_t>(index >> 32);
+
+        // Two blocks: kinematics and vertex
+        const auto r0 = philox4x32::generate({lo, hi, 0, 0}, key);
+        const auto r1 = philox4x32::generate({lo, hi, 1, 0}, key);
+
+        const scalar p =
+            _cfg.p_min + (_cfg.p_max - _cfg.p_min) * uniform(r0[0]);
+        const scalar eta =
+            _cfg.eta_min + (_cfg.eta_max - _cfg.eta_min) * uniform(r0[1]);
+        const scalar phi =
+            _cfg.phi_min + (_cfg.phi_max - _cfg.phi_min) * uniform(r0[2]);
+        const scalar q =
+            _cfg.random_charge ? ((r0[3] & 1u) ? 1. : -1.) : _cfg.charge;
+
+        // Box-Muller: two pairs of uniforms give three (and a spare) gaussians
+        const std::array<scalar, 2> g0 = gaussian(r1[0], r1[1]);
+        const std::array<scalar, 2> g1 = gaussian(r1[2], r1[3]);
+
+        const scalar theta = 2. * std::atan(std::exp(-eta));
+        const scalar sin_theta = std::sin(theta);
+
+        const point3 pos{_cfg.vertex_sigma[0] * g0[0],
+                         _cfg.vertex_sigma[1] * g0[1],
+                         _cfg.vertex_sigma[2] * g1[0]};
+        const vector3 mom{p * std::cos(phi) * sin_theta,
+                          p * std::sin(phi) * sin_theta,
+                          p * std::cos(theta)};
+
+        return track_t(pos, 0., mom, q);
+    }
+
+    /// Generate the tracks [@param first, @param first + @param n) into
+    /// @param out
+    template <typename output_itr_t>
+    void generate(const std::uint64_t first, const std::size_t n,
+                  output_itr_t out) const
+    {
+        for (std::size_t i = 0; i < n; ++i, ++out)
+        {
+            *out = (*this)(first + i);
+        }
+    }
+
+    /// Fill @param tracks (already sized) on @param n_threads threads, each
+    /// thread taking a contiguous block of the sequence, starting at
+    /// @param first
+    template <typename vector_t>
+    void fill_parallel(vector_t &tracks, const std::size_t n_threads,
+                       const std::uint64_t first = 0) const
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(n_threads);
+        for (std::size_t tid = 0; tid < n_threads; ++tid)
+        {
+            const std::size_t begin = tid * tracks.size() / n_threads;
+            const std::size_t end = (tid + 1) * tracks.size() / n_threads;
+            threads.emplace_back([this, &tracks, begin, end, first]() {
+                generate(first + begin, end - begin, tracks.begin() + begin);
+            });
+        }
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+    }
+
+    private:
+    /// Two standard normal numbers from two random words
+    static std::array<scalar, 2> gaussian(const std::uint32_t u0,
+                                          const std::uint32_t u1)
+    {
+        // Shift into (0, 1] so the logarithm stays finite
+        const scalar r = std::sqrt(-2. * std::log(1. - uniform(u0)));
+        const scalar a = 2. * M_PI * uniform(u1);
+        return {r * std::cos(a), r * std::sin(a)};
+    }
+
+    configuration _cfg{};
+};
+
+/// Structure-of-arrays track batch
+struct track_batch_soa
+{
+    std::vector<scalar> x, y, z, px, py, pz, q;
+
+    explicit track_batch_soa(const std::size_t n)
+        : x(n), y(n), z(n), px(n), py(n), pz(n), q(n)
+    {
+    }
+
+    std::size_t size() const { return x.size(); }
+
+    /// Fill element @param i from a track
+    template <typename track_t>
+    void set(const std::size_t i, const track_t &track)
+    {
+        const auto pos = track.pos();
+        const auto mom = track.mom();
+        x[i] = pos[0];
+        y[i] = pos[1];
+        z[i] = pos[2];
+        px[i] = mom[0];
+        py[i] = mom[1];
+        pz[i] = mom[2];
+        q[i] = track.charge();
+    }
+};
+
+/// Fill the @param batch on @param n_threads threads from @param gen
+template <typename track_t>
+void fill_parallel(const random_track_generator<track_t> &gen,
+                   track_batch_soa &batch, const std::size_t n_threads,
+                   const std::uint64_t first = 0)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads);
+    for (std::size_t tid = 0; tid < n_threads; ++tid)
+    {
+        const std::size_t begin = tid * batch.size() / n_threads;
+        const std::size_t end = (tid + 1) * batch.size() / n_threads;
+        threads.emplace_back([&gen, &batch, begin, end, first]() {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                batch.set(i, gen(first + i));
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+}
+
+}  // namespace detray::tutorial
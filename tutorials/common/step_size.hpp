@@ -0,0 +1,35 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// Detray include(s).
+#include "detray/propagator/rk_stepper.hpp"
+
+// System include(s).
+#include <cmath>
+
+namespace detray::tutorial {
+
+/// Set the step size of @param stepping to the distance to the next candidate
+/// of @param navigation and the step direction to its sign, then clamp the
+/// step size to the step constraints. This is the start of every step of the
+/// tutorial steppers.
+template <typename stepping_t, typename navigation_t>
+void set_step_to_next_candidate(stepping_t &stepping, navigation_t &navigation)
+{
+    stepping.set_step_size(navigation());
+
+    const step::direction step_dir = stepping.step_size() >= 0.
+                                         ? step::direction::e_forward
+                                         : step::direction::e_backward;
+    stepping.set_direction(step_dir);
+
+    const scalar max_step =
+        stepping.constraints().template size<>(stepping.direction());
+    if (std::abs(stepping.step_size()) > std::abs(max_step))
+    {
+        stepping.set_step_size(max_step);
+    }
+}
+
+}  // namespace detray::tutorial
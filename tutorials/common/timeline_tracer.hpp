@@ -0,0 +1,319 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// Detray include(s).
+#include "detray/propagator/actor_chain.hpp"
+#include "detray/propagator/navigator.hpp"
+#include "detray/propagator/propagator.hpp"
+
+// Project include(s).
+#include "propagation_loop.hpp"
+
+// System include(s).
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace detray::tutorial {
+
+/// Propagation phase of a trace event
+enum class trace_phase : std::uint8_t
+{
+    e_track = 0,
+    e_navigator_init = 1,
+    e_stepper = 2,
+    e_navigator = 3,
+    e_actors = 4
+};
+
+inline const char *to_string(const trace_phase phase)
+{
+    switch (phase)
+    {
+        case trace_phase::e_track:
+            return "track";
+        case trace_phase::e_navigator_init:
+            return "navigator init";
+        case trace_phase::e_stepper:
+            return "stepper";
+        case trace_phase::e_navigator:
+            return "navigator";
+        case trace_phase::e_actors:
+            return "actors";
+    }
+    return "unknown";
+}
+
+inline trace_phase to_trace_phase(const loop_phase phase)
+{
+    switch (phase)
+    {
+        case loop_phase::e_navigator_init:
+            return trace_phase::e_navigator_init;
+        case loop_phase::e_stepper:
+            return trace_phase::e_stepper;
+        case loop_phase::e_navigator:
+            return trace_phase::e_navigator;
+        case loop_phase::e_actors:
+            return trace_phase::e_actors;
+    }
+    return trace_phase::e_track;
+}
+
+/// Start and end of one phase of a sampled track, in ns since the tracer epoch
+struct trace_event
+{
+    std::uint64_t track_id;
+    std::int64_t start;
+    std::int64_t end;
+    trace_phase phase;
+};
+
+/// Event buffer of a single thread.
+///
+/// The memory is allocated up front and only the owning thread writes to it,
+/// so recording needs neither locks nor atomics. Events that do not fit are
+/// counted and dropped. The event of a whole track is reserved when the track
+/// starts, so a track that overflows the buffer loses its last phases, but
+/// keeps its span. Buffers of different threads do not share a cache line.
+class alignas(64) trace_buffer
+{
+    public:
+    using clock = std::chrono::steady_clock;
+
+    trace_buffer(const clock::time_point epoch, const std::size_t capacity)
+        : _epoch(epoch)
+    {
+        _events.reserve(capacity);
+    }
+
+    std::int64_t now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   clock::now() - _epoch)
+            .count();
+    }
+
+    void record(const trace_phase phase, const std::uint64_t track_id,
+                const std::int64_t start, const std::int64_t end)
+    {
+        if (_events.size() < _events.capacity())
+        {
+            _events.push_back({track_id, start, end, phase});
+        }
+        else
+        {
+            ++_n_dropped;
+        }
+    }
+
+    /// Reserve the event of track @param track_id, which starts at
+    /// @param start.
+    ///
+    /// @returns the event index to pass to @c end_track, or @c npos if the
+    /// buffer is full
+    std::size_t begin_track(const std::uint64_t track_id,
+                            const std::int64_t start)
+    {
+        if (_events.size() < _events.capacity())
+        {
+            _events.push_back({track_id, start, start, trace_phase::e_track});
+            return _events.size() - 1;
+        }
+        ++_n_dropped;
+        return npos;
+    }
+
+    /// Set the end of the track event @param idx from @c begin_track
+    void end_track(const std::size_t idx, const std::int64_t end)
+    {
+        if (idx != npos)
+        {
+            _events[idx].end = end;
+        }
+    }
+
+    const std::vector<trace_event> &events() const { return _events; }
+
+    std::size_t n_dropped() const { return _n_dropped; }
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    private:
+    clock::time_point _epoch;
+    std::vector<trace_event> _events{};
+    std::size_t _n_dropped{0};
+};
+
+/// Owns one trace buffer per thread and decides which tracks are sampled
+class timeline_tracer
+{
+    public:
+    /// @param sample_interval trace one in this many tracks, 0 traces none
+    /// @param capacity_per_thread number of events a thread can record, see
+    ///        @c expected_capacity
+    timeline_tracer(const std::size_t n_threads,
+                    const std::size_t sample_interval,
+                    const std::size_t capacity_per_thread)
+        : _sample_interval(sample_interval)
+    {
+        const auto epoch = trace_buffer::clock::now();
+        _buffers.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i)
+        {
+            _buffers.emplace_back(epoch, capacity_per_thread);
+        }
+    }
+
+    /// Buffer capacity for @param n_tracks split evenly over @param n_threads
+    /// threads, if no track takes more than @param max_steps steps.
+    ///
+    /// A sampled track records the three phases of the initialization and of
+    /// every step, and the whole track. The number of sampled tracks of a
+    /// thread fluctuates with the hash, so twice the mean (rounded up) plus
+    /// one is kept.
+    static std::size_t expected_capacity(const std::size_t n_tracks,
+                                         const std::size_t n_threads,
+                                         const std::size_t sample_interval,
+                                         const std::size_t max_steps)
+    {
+        if (sample_interval == 0 or n_threads == 0)
+        {
+            return 0;
+        }
+        const std::size_t n_per_sample = sample_interval * n_threads;
+        const std::size_t n_sampled =
+            (n_tracks + n_per_sample - 1) / n_per_sample;
+        const std::size_t events_per_track = 3 * (max_steps + 1) + 1;
+
+        return (2 * n_sampled + 1) * events_per_track;
+    }
+
+    /// The sample is a hash of the track id, so it does not depend on how the
+    /// tracks are distributed over the threads
+    bool is_sampled(const std::uint64_t track_id) const
+    {
+        if (_sample_interval == 0)
+        {
+            return false;
+        }
+        // splitmix64 finalizer
+        std::uint64_t z = track_id + 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        z = z ^ (z >> 31);
+        return z % _sample_interval == 0;
+    }
+
+    trace_buffer &buffer(const std::size_t thread_idx)
+    {
+        return _buffers[thread_idx];
+    }
+
+    const std::vector<trace_buffer> &buffers() const { return _buffers; }
+
+    /// Write all events in the Chrome trace event format, which both
+    /// chrome://tracing and the Perfetto UI can open. Only call this once all
+    /// threads are done recording.
+    void write_chrome_trace(std::ostream &out) const
+    {
+        // Time stamps are in us, keep the ns digits
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first{true};
+        for (std::size_t tid = 0; tid < _buffers.size(); ++tid)
+        {
+            for (const auto &e : _buffers[tid].events())
+            {
+                out << (first ? "\n" : ",\n") << "{\"name\":\""
+                    << to_string(e.phase)
+                    << "\",\"cat\":\"propagation\",\"ph\":\"X\",\"pid\":0,"
+                    << "\"tid\":" << tid << ",\"ts\":" << e.start / 1000.
+                    << ",\"dur\":" << (e.end - e.start) / 1000.
+                    << ",\"args\":{\"track\":" << e.track_id << "}}";
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    private:
+    std::size_t _sample_interval;
+    std::vector<trace_buffer> _buffers{};
+};
+
+/// Runs the loop of @c propagator::propagate and, for sampled tracks, records
+/// the stepper, navigator and actor phases of every step.
+template <typename stepper_t, typename detector_t,
+          typename actor_chain_t = actor_chain<>>
+class traced_propagator
+{
+    public:
+    using navigator_type = navigator<detector_t>;
+    using propagator_type =
+        propagator<stepper_t, navigator_type, actor_chain_t>;
+    using state = typename propagator_type::state;
+
+    traced_propagator(stepper_t &&s, const detector_t &det)
+        : _stepper(std::move(s)), _navigator(det)
+    {
+    }
+
+    /// Propagate a track, recording into @param buffer if it is not null
+    bool propagate(state &propagation, const std::uint64_t track_id,
+                   trace_buffer *buffer = nullptr)
+    {
+        if (buffer == nullptr)
+        {
+            if (init_propagation(propagation, _navigator, _actor_chain))
+            {
+                while (propagation_step(propagation, _stepper, _navigator,
+                                        _actor_chain))
+                {
+                }
+            }
+            return propagation._navigation.is_complete();
+        }
+
+        // Every phase ends where the next one starts
+        const std::int64_t track_start = buffer->now();
+        const std::size_t track_event =
+            buffer->begin_track(track_id, track_start);
+        std::int64_t t = track_start;
+        const auto record = [buffer, track_id, &t](const loop_phase phase) {
+            const std::int64_t start = t;
+            t = buffer->now();
+            buffer->record(to_trace_phase(phase), track_id, start, t);
+        };
+
+        if (init_propagation(propagation, _navigator, _actor_chain, record))
+        {
+            while (propagation_step(propagation, _stepper, _navigator,
+                                    _actor_chain, record))
+            {
+            }
+        }
+
+        buffer->end_track(track_event, t);
+
+        return propagation._navigation.is_complete();
+    }
+
+    private:
+    stepper_t _stepper;
+    navigator_type _navigator;
+    actor_chain_t _actor_chain{};
+};
+
+}  // namespace detray::tutorial
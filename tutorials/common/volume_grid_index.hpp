@@ -0,0 +1,206 @@
+/** Detray tutorial project, No copy right **/
+
+#pragma once
+
+// Detray include(s).
+#include "detray/definitions/indexing.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace detray::tutorial {
+
+/// Volume extent: rmin, rmax, zmin, zmax, phimin, phimax
+using volume_bounds = std::array<scalar, 6>;
+
+/// Is the point (@param r, @param z, @param phi) inside @param bounds
+inline bool is_inside(const volume_bounds &bounds, const scalar r,
+                      const scalar z, const scalar phi)
+{
+    return r >= bounds[0] and r < bounds[1] and z >= bounds[2] and
+           z < bounds[3] and phi >= bounds[4] and phi <= bounds[5];
+}
+
+/// Reference: test the bounds of every volume in turn
+template <typename detector_t>
+dindex linear_volume_search(const detector_t &det, const point3 &p)
+{
+    const scalar r = std::sqrt(p[0] * p[0] + p[1] * p[1]);
+    const scalar phi = std::atan2(p[1], p[0]);
+    for (const auto &v : det.volumes())
+    {
+        if (is_inside(v.bounds(), r, p[2], phi))
+        {
+            return v.index();
+        }
+    }
+    return dindex_invalid;
+}
+
+/// Regular r/z/phi grid over the detector volumes.
+///
+/// Every cell lists the volumes that overlap it, in the order of the volume
+/// index. Most cells lie inside a single volume; only cells on a volume
+/// boundary hold more than one. A lookup computes the cell directly from the
+/// point and checks the bounds of its few volumes, so it takes constant time
+/// and returns the same volume as the linear search.
+template <typename detector_t>
+class volume_grid_index
+{
+    public:
+    struct configuration
+    {
+        std::size_t n_r_bins{256};
+        std::size_t n_z_bins{512};
+        std::size_t n_phi_bins{1};
+    };
+
+    explicit volume_grid_index(const detector_t &det)
+        : volume_grid_index(det, configuration{})
+    {
+    }
+
+    volume_grid_index(const detector_t &det, const configuration &cfg)
+        : _n_bins{cfg.n_r_bins, cfg.n_z_bins, cfg.n_phi_bins}
+    {
+        // Detector extent
+        _min = {0., std::numeric_limits<scalar>::max(), -M_PI};
+        std::array<scalar, 3> max{0., -std::numeric_limits<scalar>::max(),
+                                  M_PI};
+        for (const auto &v : det.volumes())
+        {
+            const auto &b = v.bounds();
+            _bounds.push_back({b[0], b[1], b[2], b[3], b[4], b[5]});
+            max[0] = std::max(max[0], b[1]);
+            _min[1] = std::min(_min[1], b[2]);
+            max[1] = std::max(max[1], b[3]);
+        }
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            _inv_width[i] = _n_bins[i] / (max[i] - _min[i]);
+        }
+
+        // Count, then fill the volumes per cell
+        const std::size_t n_cells = _n_bins[0] * _n_bins[1] * _n_bins[2];
+        _offsets.assign(n_cells + 1, 0);
+        for_each_overlap([this](const std::size_t cell, const dindex) {
+            ++_offsets[cell + 1];
+        });
+        for (std::size_t cell = 0; cell < n_cells; ++cell)
+        {
+            _offsets[cell + 1] += _offsets[cell];
+        }
+
+        _volumes.resize(_offsets.back());
+        std::vector<std::size_t> fill(_offsets.begin(), _offsets.end() - 1);
+        for_each_overlap([this, &fill](const std::size_t cell,
+                                       const dindex vol) {
+            _volumes[fill[cell]++] = vol;
+        });
+    }
+
+    /// @returns the index of the volume that contains @param p, or
+    /// @c dindex_invalid if it lies outside of the detector
+    dindex find(const point3 &p) const
+    {
+        const scalar r = std::sqrt(p[0] * p[0] + p[1] * p[1]);
+        const scalar phi = std::atan2(p[1], p[0]);
+        const std::array<scalar, 3> loc{r, p[2], phi};
+
+        std::size_t cell{0};
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            const scalar x = (loc[i] - _min[i]) * _inv_width[i];
+            if (not(x >= 0.) or x >= _n_bins[i])
+            {
+                // Allow phi = pi and the outer edges of the last bin
+                if (x >= _n_bins[i] and x < _n_bins[i] + 1e-3f)
+                {
+                    cell = cell * _n_bins[i] + _n_bins[i] - 1;
+                    continue;
+                }
+                return dindex_invalid;
+            }
+            cell = cell * _n_bins[i] + static_cast<std::size_t>(x);
+        }
+
+        for (std::size_t i = _offsets[cell]; i < _offsets[cell + 1]; ++i)
+        {
+            if (is_inside(_bounds[_volumes[i]], r, p[2], phi))
+            {
+                return _volumes[i];
+            }
+        }
+        return dindex_invalid;
+    }
+
+    /// Largest number of volumes in a cell
+    std::size_t max_cell_size() const
+    {
+        std::size_t n{0};
+        for (std::size_t cell = 0; cell + 1 < _offsets.size(); ++cell)
+        {
+            n = std::max(n, _offsets[cell + 1] - _offsets[cell]);
+        }
+        return n;
+    }
+
+    /// Memory footprint of the index in bytes
+    std::size_t size_in_bytes() const
+    {
+        return _offsets.size() * sizeof(std::size_t) +
+               _volumes.size() * sizeof(dindex) +
+               _bounds.size() * sizeof(volume_bounds);
+    }
+
+    private:
+    /// Call @param func(cell, volume) for every cell a volume overlaps
+    template <typename func_t>
+    void for_each_overlap(func_t &&func) const
+    {
+        for (std::size_t vol = 0; vol < _bounds.size(); ++vol)
+        {
+            const auto &b = _bounds[vol];
+            const std::array<std::size_t, 3> lo{bin(0, b[0]), bin(1, b[2]),
+                                                bin(2, b[4])};
+            const std::array<std::size_t, 3> hi{bin(0, b[1]), bin(1, b[3]),
+                                                bin(2, b[5])};
+            for (std::size_t i = lo[0]; i <= hi[0]; ++i)
+            {
+                for (std::size_t j = lo[1]; j <= hi[1]; ++j)
+                {
+                    for (std::size_t k = lo[2]; k <= hi[2]; ++k)
+                    {
+                        func((i * _n_bins[1] + j) * _n_bins[2] + k,
+                             static_cast<dindex>(vol));
+                    }
+                }
+            }
+        }
+    }
+
+    /// Bin of @param x on axis @param axis, clamped to the axis
+    std::size_t bin(const std::size_t axis, const scalar x) const
+    {
+        const scalar b = (x - _min[axis]) * _inv_width[axis];
+        if (b <= 0.)
+        {
+            return 0;
+        }
+        return std::min(static_cast<std::size_t>(b), _n_bins[axis] - 1);
+    }
+
+    std::array<std::size_t, 3> _n_bins;
+    std::array<scalar, 3> _min{};
+    std::array<scalar, 3> _inv_width{};
+    std::vector<std::size_t> _offsets{};
+    std::vector<dindex> _volumes{};
+    std::vector<volume_bounds> _bounds{};
+};
+
+}  // namespace detray::tutorial
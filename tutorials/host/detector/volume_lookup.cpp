@@ -0,0 +1,148 @@
+/** Detray tutorial project, No copy right **/
+
+// This tutorial finds the volume that contains a given position, e.g. the
+// start volume of a track seed:
+// 1. Build a regular r/z/phi grid over the volumes of the toy detector
+// 2. Draw random positions inside the detector envelope
+// 3. Look them up with a linear search over all volumes and with the grid
+// Both have to agree; the time per lookup of both is printed.
+
+// Detray include(s).
+#include "detray/plugins/algebra/array_definitions.hpp"
+#include "tests/common/tools/create_toy_geometry.hpp"
+
+// Project include(s).
+#include "random_track_generator.hpp"
+#include "volume_grid_index.hpp"
+
+// Vecmem include(s).
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace detray;
+
+int main(int argc, char *argv[])
+{
+    /*****************
+     * Initial Setup *
+     *****************/
+
+    // Number of positions (default 4M)
+    std::size_t n_points{1ul << 22};
+    if (argc == 2)
+    {
+        n_points = std::stoul(argv[1]);
+    }
+
+    // Detector configuration (this particular one is the most well tested)
+    constexpr std::size_t n_brl_layers{4};  // up to 4 barrel layers
+    constexpr std::size_t n_edc_layers{7};  // up to 7 endacap layers
+    // Do host-side allocation only
+    vecmem::host_memory_resource host_mr;
+
+    // Pixel detector of the ACTS generic detector
+    auto det = create_toy_geometry(host_mr, n_brl_layers, n_edc_layers);
+    using detector_t = decltype(det);
+
+    // Build the grid
+    /*time*/ auto start_time = std::chrono::system_clock::now();
+
+    const tutorial::volume_grid_index<detector_t> volume_index(det);
+
+    /*time*/ auto end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> build_time = end_time - start_time;
+
+    std::cout << "Volumes: " << det.volumes().size()
+              << ", grid build time [s]: " << build_time.count()
+              << ", size [kB]: " << volume_index.size_in_bytes() / 1024.
+              << ", max. volumes per cell: " << volume_index.max_cell_size()
+              << std::endl;
+
+    // Detector envelope
+    scalar r_max{0.};
+    scalar z_min{0.};
+    scalar z_max{0.};
+    for (const auto &v : det.volumes())
+    {
+        r_max = std::max(r_max, v.bounds()[1]);
+        z_min = std::min(z_min, v.bounds()[2]);
+        z_max = std::max(z_max, v.bounds()[3]);
+    }
+
+    // Random positions, uniform in the envelope
+    std::vector<point3> points(n_points);
+    for (std::size_t i = 0; i < n_points; ++i)
+    {
+        const auto rnd = tutorial::uniform4(7, i);
+        const scalar r = r_max * std::sqrt(rnd[0]);
+        const scalar phi = 2. * M_PI * rnd[1] - M_PI;
+        points[i] = {r * std::cos(phi), r * std::sin(phi),
+                     z_min + (z_max - z_min) * rnd[2]};
+    }
+
+    /*****************
+     * Linear search *
+     *****************/
+
+    std::vector<dindex> linear_result(n_points);
+
+    /*time*/ start_time = std::chrono::system_clock::now();
+
+    for (std::size_t i = 0; i < n_points; ++i)
+    {
+        linear_result[i] = tutorial::linear_volume_search(det, points[i]);
+    }
+
+    /*time*/ end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> linear_time = end_time - start_time;
+
+    /***************
+     * Grid lookup *
+     ***************/
+
+    std::vector<dindex> grid_result(n_points);
+
+    /*time*/ start_time = std::chrono::system_clock::now();
+
+    for (std::size_t i = 0; i < n_points; ++i)
+    {
+        grid_result[i] = volume_index.find(points[i]);
+    }
+
+    /*time*/ end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> grid_time = end_time - start_time;
+
+    /**********
+     * Result *
+     **********/
+
+    std::size_t n_mismatch{0};
+    for (std::size_t i = 0; i < n_points; ++i)
+    {
+        n_mismatch += (linear_result[i] != grid_result[i]);
+    }
+    const std::size_t n_outside = static_cast<std::size_t>(
+        std::count(linear_result.begin(), linear_result.end(), dindex_invalid));
+
+    std::cout << "Positions: " << n_points << ", outside of all volumes: "
+              << n_outside << std::endl;
+    std::cout << "linear search: " << std::setw(8)
+              << 1e9 * linear_time.count() / n_points << " ns/lookup"
+              << std::endl;
+    std::cout << "grid lookup:   " << std::setw(8)
+              << 1e9 * grid_time.count() / n_points << " ns/lookup"
+              << "   speedup: " << linear_time.count() / grid_time.count()
+              << std::endl;
+    std::cout << "Results agree: " << std::boolalpha << (n_mismatch == 0)
+              << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,320 @@
+/** Detray tutorial project, No copy right **/
+
+// This tutorial compares two ways of keeping the navigation candidates of a
+// volume up to date while a track moves through it:
+// 1. Re-intersect every object of the volume and sort the full list at every
+//    step (what the navigator does)
+// 2. Start from the precomputed object list of the volume and keep only the
+//    next few candidates exact, re-sorting them incrementally
+// First, both candidate lists walk straight tracks through the toy detector
+// in fixed steps and have to find the same sequence of surfaces. Then the
+// incremental lists navigate the propagator, in place of the navigator, for
+// curved tracks in a 2T field: both propagate the same tracks with the RK
+// stepper, and the modules they find are compared to the ones the particle
+// gun finds on the helix of every track.
+
+// Detray include(s).
+#include "detray/plugins/algebra/array_definitions.hpp"
+#include "detray/definitions/units.hpp"
+#include "detray/field/constant_magnetic_field.hpp"
+#include "detray/propagator/actor_chain.hpp"
+#include "detray/propagator/navigator.hpp"
+#include "detray/propagator/propagator.hpp"
+#include "detray/propagator/rk_stepper.hpp"
+#include "detray/propagator/track.hpp"
+#include "tests/common/tools/create_toy_geometry.hpp"
+#include "tests/common/tools/track_generators.hpp"
+
+// Project include(s).
+#include "candidate_cache.hpp"
+#include "navigation_validation.hpp"
+
+// Vecmem include(s).
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace detray;
+
+namespace {
+
+/// Result of walking one batch of tracks
+struct walk_result
+{
+    /// Surfaces (modules and portals) reached by every track
+    std::vector<std::vector<dindex>> surface_traces{};
+    std::size_t n_steps{0};
+    std::size_t n_intersections{0};
+    double time{0.};
+};
+
+/// Walk every straight track in steps of @param step_size from volume 0 until
+/// it leaves the detector, using @param cands to find the next surface
+template <typename detector_t, typename candidates_t>
+walk_result walk(const detector_t &det,
+                 const std::vector<free_track_parameters> &tracks,
+                 candidates_t &cands, const scalar step_size)
+{
+    walk_result result{};
+    result.surface_traces.resize(tracks.size());
+
+    /*time*/ auto start_time = std::chrono::system_clock::now();
+
+    for (std::size_t trk = 0; trk < tracks.size(); ++trk)
+    {
+        auto track = tracks[trk];
+        dindex volume{0};
+        scalar walked{0.};
+        cands.init(volume, track, walked);
+
+        while (cands.has_next())
+        {
+            const auto &next = cands.next();
+            const scalar dist = next.key - walked;
+            const scalar h = std::min(step_size, dist);
+
+            track.set_pos(track.pos() + h * track.dir());
+            walked += h;
+            ++result.n_steps;
+
+            // Reached the next surface: switch volume on portals
+            if (h == dist)
+            {
+                result.surface_traces[trk].push_back(next.sf_index);
+                if (next.sfi.link != volume)
+                {
+                    volume = next.sfi.link;
+                    if (volume >= det.volumes().size())
+                    {
+                        break;
+                    }
+                    cands.init(volume, track, walked);
+                    continue;
+                }
+            }
+            cands.update(track, walked);
+        }
+    }
+
+    /*time*/ auto end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> time = end_time - start_time;
+
+    result.time = time.count();
+    result.n_intersections = cands.n_intersections();
+
+    return result;
+}
+
+void print(const std::string &name, const walk_result &result)
+{
+    std::cout << std::setw(28) << std::left << name << std::right
+              << "steps: " << std::setw(9) << result.n_steps
+              << "   intersections/step: " << std::setw(8)
+              << std::setprecision(3)
+              << static_cast<double>(result.n_intersections) /
+                     static_cast<double>(result.n_steps)
+              << "   time/step [ns]: " << std::setw(8)
+              << 1e9 * result.time / static_cast<double>(result.n_steps)
+              << std::endl;
+}
+
+/// Only the incremental navigator counts its intersections
+template <typename navigator_t>
+struct is_incremental : std::false_type
+{
+};
+
+template <typename detector_t>
+struct is_incremental<tutorial::incremental_navigator<detector_t>>
+    : std::true_type
+{
+};
+
+/// Propagate all @param tracks with @param nav and compare the modules found
+/// to @param truth_traces
+template <typename navigator_t, typename field_t>
+void propagate(const std::string &name, navigator_t nav,
+               const field_t &B_field,
+               const std::vector<free_track_parameters> &tracks,
+               const std::vector<std::vector<dindex>> &truth_traces)
+{
+    using stepper_type =
+        rk_stepper<field_t, free_track_parameters, constrained_step<>>;
+    using actor_chain_type =
+        actor_chain<std::tuple, tutorial::module_recorder>;
+    using propagator_type =
+        propagator<stepper_type, navigator_t, actor_chain_type>;
+
+    propagator_type p(stepper_type{B_field}, std::move(nav));
+
+    std::vector<tutorial::module_recorder::state> recorder_states(
+        tracks.size());
+    std::size_t n_intersections{0};
+
+    /*time*/ auto start_time = std::chrono::system_clock::now();
+
+    for (std::size_t trk = 0; trk < tracks.size(); ++trk)
+    {
+        typename propagator_type::state state(
+            tracks[trk], std::tie(recorder_states[trk]));
+        state._stepping.template set_constraint<step::constraint::e_accuracy>(
+            30 * unit_constants::mm);
+        p.propagate(state);
+
+        if constexpr (is_incremental<navigator_t>::value)
+        {
+            n_intersections += state._navigation.n_intersections();
+        }
+    }
+
+    /*time*/ auto end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> time = end_time - start_time;
+
+    std::size_t n_steps{0};
+    std::size_t n_truth_modules{0};
+    std::size_t n_found{0};
+    std::size_t n_matched_tracks{0};
+    for (std::size_t trk = 0; trk < tracks.size(); ++trk)
+    {
+        const auto &rec = recorder_states[trk];
+
+        n_steps += rec.n_steps();
+        n_truth_modules += truth_traces[trk].size();
+        n_found += tutorial::n_found_modules(truth_traces[trk], rec.modules);
+        n_matched_tracks += (rec.modules == truth_traces[trk]);
+    }
+
+    std::cout << std::setw(28) << std::left << name << std::right
+              << "steps/track: " << std::setw(7) << std::setprecision(4)
+              << static_cast<double>(n_steps) / tracks.size()
+              << "   time/step [ns]: " << std::setw(8)
+              << 1e9 * time.count() / static_cast<double>(n_steps)
+              << "   tracks/s: " << std::setw(10)
+              << tracks.size() / time.count();
+    if constexpr (is_incremental<navigator_t>::value)
+    {
+        std::cout << "   intersections/step: " << std::setw(8)
+                  << static_cast<double>(n_intersections) /
+                         static_cast<double>(n_steps);
+    }
+    std::cout << "   modules found: " << n_found << "/" << n_truth_modules
+              << "   tracks with the truth module sequence: "
+              << n_matched_tracks << "/" << tracks.size() << std::endl;
+}
+
+}  // anonymous namespace
+
+int main()
+{
+    /*****************
+     * Initial Setup *
+     *****************/
+
+    // Detector setup for the number of layers
+    constexpr std::size_t n_barrel_layers = 4;
+    constexpr std::size_t n_endcap_layers = 7;
+
+    // Track batch setup (50 X 50 == 2500 tracks)
+    constexpr std::size_t n_theta_steps = 50;
+    constexpr std::size_t n_phi_steps = 50;
+
+    // Step size of the walk, small compared to the layer spacing
+    constexpr scalar step_size{2. * unit_constants::mm};
+
+    // Set up the constant magnetic field of the curved tracks
+    constexpr scalar B_z{2. * unit_constants::T};
+    const vector3 B{0, 0, B_z};
+    constant_magnetic_field<> B_field(B);
+
+    // VecMem memory resource(s)
+    vecmem::host_memory_resource host_resource;
+
+    // Create the TrackML (toy) geometry
+    auto det =
+        create_toy_geometry(host_resource, n_barrel_layers, n_endcap_layers);
+    using detector_t = decltype(det);
+
+    // The object lists of the volumes are built once
+    tutorial::volume_candidate_index<detector_t> cand_index(det);
+
+    std::size_t max_population{0};
+    for (dindex vol = 0; vol < cand_index.n_volumes(); ++vol)
+    {
+        max_population = std::max(max_population, cand_index.size(vol));
+    }
+    std::cout << "Volumes: " << cand_index.n_volumes()
+              << ", largest volume population: " << max_population
+              << std::endl;
+
+    // Straight tracks from the origin
+    std::vector<free_track_parameters> tracks;
+    const point3 ori{0., 0., 0.};
+    for (auto track : uniform_track_generator<free_track_parameters>(
+             n_theta_steps, n_phi_steps, ori, 10. * unit_constants::GeV))
+    {
+        tracks.push_back(track);
+    }
+
+    // Curved tracks from the origin, with a low momentum so that the tangent
+    // drifts away from the helix quickly
+    std::vector<free_track_parameters> curved_tracks;
+    std::vector<std::vector<dindex>> truth_traces;
+    for (auto track : uniform_track_generator<free_track_parameters>(
+             n_theta_steps, n_phi_steps, ori, 1. * unit_constants::GeV))
+    {
+        track.set_overstep_tolerance(-7. * unit_constants::um);
+        curved_tracks.push_back(track);
+        truth_traces.push_back(tutorial::truth_module_trace(det, track, B));
+    }
+
+    /*******************
+     * Straight tracks *
+     *******************/
+
+    std::cout << std::endl << "Straight tracks:" << std::endl;
+
+    tutorial::sorted_candidates<detector_t> sorted(det, cand_index);
+    const auto ref = walk(det, tracks, sorted, step_size);
+    print("full intersect + sort", ref);
+
+    for (const std::size_t n_exact : {1, 2, 4, 8})
+    {
+        tutorial::incremental_candidates<detector_t> incremental(
+            det, cand_index, n_exact);
+        const auto res = walk(det, tracks, incremental, step_size);
+        print("incremental (top " + std::to_string(n_exact) + ")", res);
+
+        if (res.surface_traces != ref.surface_traces)
+        {
+            std::cout << "  -> surface sequence differs from the reference!"
+                      << std::endl;
+        }
+    }
+
+    /****************************
+     * Propagation, curved (2T) *
+     ****************************/
+
+    std::cout << std::endl << "Propagation of curved tracks (2T):" << std::endl;
+
+    propagate("navigator", navigator<detector_t>{det}, B_field,
+              curved_tracks, truth_traces);
+
+    for (const std::size_t n_exact : {1, 2, 4, 8})
+    {
+        propagate("incremental (top " + std::to_string(n_exact) + ")",
+                  tutorial::incremental_navigator<detector_t>(
+                      det, cand_index, n_exact, B_z),
+                  B_field, curved_tracks, truth_traces);
+    }
+
+    return 0;
+}
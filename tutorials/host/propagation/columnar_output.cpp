@@ -0,0 +1,222 @@
+/** Detray tutorial project, No copy right **/
+
+// This tutorial stores the per-surface results of a propagation run on disk:
+// 1. An actor collects track id, volume/surface id, path length, local
+//    position and direction on every module the track crosses
+// 2. The hits are written once as CSV and once in the columnar binary format
+//    (delta coded ids, dictionary coded volumes, chunked writes)
+// 3. A single column and then the complete file are read back and checked
+// The sizes per hit and the write throughput of both formats are printed.
+
+// Detray include(s).
+#include "detray/plugins/algebra/array_definitions.hpp"
+#include "detray/definitions/units.hpp"
+#include "detray/field/constant_magnetic_field.hpp"
+#include "detray/propagator/actor_chain.hpp"
+#include "detray/propagator/base_actor.hpp"
+#include "detray/propagator/navigator.hpp"
+#include "detray/propagator/propagator.hpp"
+#include "detray/propagator/rk_stepper.hpp"
+#include "detray/propagator/track.hpp"
+#include "tests/common/tools/create_toy_geometry.hpp"
+#include "tests/common/tools/track_generators.hpp"
+
+// Project include(s).
+#include "columnar_output.hpp"
+
+// Vecmem include(s).
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace detray;
+
+/// Actor that collects the track state on every module
+struct hit_collector : actor
+{
+    struct state
+    {
+        std::uint64_t track_id{0};
+        std::vector<tutorial::surface_hit> *hits{nullptr};
+    };
+
+    template <typename propagator_state_t>
+    void operator()(state &collector_state,
+                    const propagator_state_t &prop_state) const
+    {
+        const auto &stepping = prop_state._stepping;
+        const auto &navigation = prop_state._navigation;
+
+        if (navigation.is_on_module())
+        {
+            const auto &track = stepping();
+            const auto dir = track.dir();
+            const auto &sfi = *navigation.current();
+
+            collector_state.hits->push_back(
+                {collector_state.track_id,
+                 static_cast<std::uint32_t>(sfi.link),
+                 static_cast<std::uint32_t>(sfi.index),
+                 static_cast<float>(stepping.path_length()),
+                 {static_cast<float>(sfi.p2[0]),
+                  static_cast<float>(sfi.p2[1])},
+                 {static_cast<float>(dir[0]), static_cast<float>(dir[1]),
+                  static_cast<float>(dir[2])}});
+        }
+    }
+};
+
+namespace {
+
+std::size_t file_size(const std::string &file_name)
+{
+    std::ifstream in(file_name, std::ios::binary | std::ios::ate);
+    return static_cast<std::size_t>(in.tellg());
+}
+
+void print(const std::string &name, const std::size_t n_bytes,
+           const std::size_t n_hits, const double time)
+{
+    std::cout << std::setw(10) << std::left << name << std::right
+              << "bytes/hit: " << std::setw(8) << std::setprecision(4)
+              << static_cast<double>(n_bytes) / n_hits
+              << "   write time [s]: " << std::setw(10) << time
+              << "   hits/s: " << std::setw(10) << n_hits / time
+              << "   MB/s: " << std::setw(8) << 1e-6 * n_bytes / time
+              << std::endl;
+}
+
+}  // anonymous namespace
+
+int main()
+{
+    /*****************
+     * Initial Setup *
+     *****************/
+
+    // Track batch setup (100 X 100 == 10000 tracks)
+    constexpr std::size_t n_theta_steps = 100;
+    constexpr std::size_t n_phi_steps = 100;
+
+    // Detector setup for the number of layers
+    constexpr std::size_t n_barrel_layers = 4;
+    constexpr std::size_t n_endcap_layers = 7;
+
+    // Output files
+    const std::string csv_file{"surface_hits.csv"};
+    const std::string col_file{"surface_hits.dcol"};
+
+    // Set up the constant magnetic field
+    const vector3 B{0, 0, 2 * unit_constants::T};
+    constant_magnetic_field<> B_field(B);
+
+    // VecMem memory resource(s)
+    vecmem::host_memory_resource host_resource;
+
+    // Create the TrackML (toy) geometry
+    auto detector =
+        create_toy_geometry(host_resource, n_barrel_layers, n_endcap_layers);
+    using detector_type = decltype(detector);
+
+    using rk_stepper_type =
+        rk_stepper<constant_magnetic_field<>, free_track_parameters,
+                   constrained_step<>>;
+    using navigator_type = navigator<detector_type>;
+    using actor_chain_type = actor_chain<std::tuple, hit_collector>;
+    using propagator_type =
+        propagator<rk_stepper_type, navigator_type, actor_chain_type>;
+
+    /***************
+     * Propagation *
+     ***************/
+
+    propagator_type p(rk_stepper_type{B_field}, navigator_type{detector});
+
+    std::vector<tutorial::surface_hit> hits;
+
+    std::uint64_t track_id{0};
+    const point3 ori{0., 0., 0.};
+    for (auto track : uniform_track_generator<free_track_parameters>(
+             n_theta_steps, n_phi_steps, ori, 10. * unit_constants::GeV))
+    {
+        track.set_overstep_tolerance(-7. * unit_constants::um);
+
+        hit_collector::state collector_state{track_id++, &hits};
+        propagator_type::state state(track, std::tie(collector_state));
+        p.propagate(state);
+    }
+
+    std::cout << "Tracks: " << track_id << ", hits: " << hits.size()
+              << std::endl;
+
+    /**********
+     * Output *
+     **********/
+
+    // CSV dump
+    /*time*/ auto start_time = std::chrono::system_clock::now();
+    {
+        std::ofstream csv(csv_file);
+        csv << "track_id,volume_id,surface_id,path,loc0,loc1,dir_x,dir_y,"
+               "dir_z\n";
+        for (const auto &h : hits)
+        {
+            csv << h.track_id << ',' << h.volume_id << ',' << h.surface_id
+                << ',' << h.path << ',' << h.local[0] << ',' << h.local[1]
+                << ',' << h.dir[0] << ',' << h.dir[1] << ',' << h.dir[2]
+                << '\n';
+        }
+    }
+    /*time*/ auto end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> csv_time = end_time - start_time;
+
+    // Columnar file
+    /*time*/ start_time = std::chrono::system_clock::now();
+    {
+        tutorial::columnar_writer writer(col_file);
+        for (const auto &h : hits)
+        {
+            writer.write(h);
+        }
+        writer.close();
+    }
+    /*time*/ end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> col_time = end_time - start_time;
+
+    print("CSV", file_size(csv_file), hits.size(), csv_time.count());
+    print("columnar", file_size(col_file), hits.size(), col_time.count());
+
+    /*************
+     * Read back *
+     *************/
+
+    tutorial::columnar_reader reader(col_file);
+
+    // A single column, without decoding the others
+    /*time*/ start_time = std::chrono::system_clock::now();
+    const auto surface_ids = reader.read_ids(tutorial::column::e_surface_id);
+    /*time*/ end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> read_time = end_time - start_time;
+
+    bool is_consistent = surface_ids.size() == hits.size();
+    for (std::size_t i = 0; is_consistent and i < hits.size(); ++i)
+    {
+        is_consistent &= (surface_ids[i] == hits[i].surface_id);
+    }
+    std::cout << "surface id column read in " << read_time.count()
+              << " s, consistent: " << std::boolalpha << is_consistent
+              << std::endl;
+
+    // All columns
+    std::cout << "full file round trip: " << std::boolalpha
+              << (reader.read_all() == hits) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,255 @@
+/** Detray tutorial project, No copy right **/
+
+// This tutorial measures what carrying the covariance along the path costs on
+// top of the propagation of bare free track parameters:
+// 1. Propagate the track batch with the covariant RK stepper, with the
+//    Jacobian and the transport switched off
+// 2. Propagate it with the same stepper, which now computes the transport
+//    Jacobian of every step from its Runge-Kutta stages and transports the
+//    8x8 free covariance right away, one track at a time
+// 3. Propagate it again in lockstep batches of W tracks, with one batched
+//    covariance transport for all W tracks per step
+// All runs take the same steps and run the same actors, so the difference in
+// time is the cost of the transport. The covariance is recorded on every
+// module; 2. and 3. have to agree.
+
+// Detray include(s).
+#include "detray/plugins/algebra/array_definitions.hpp"
+#include "detray/definitions/units.hpp"
+#include "detray/field/constant_magnetic_field.hpp"
+#include "detray/propagator/actor_chain.hpp"
+#include "detray/propagator/navigator.hpp"
+#include "detray/propagator/propagator.hpp"
+#include "detray/propagator/rk_stepper.hpp"
+#include "detray/propagator/track.hpp"
+#include "tests/common/tools/create_toy_geometry.hpp"
+#include "tests/common/tools/track_generators.hpp"
+
+// Project include(s).
+#include "covariance_transport.hpp"
+#include "navigation_validation.hpp"
+
+// Vecmem include(s).
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace detray;
+
+namespace {
+
+using field_type = constant_magnetic_field<>;
+using covariant_stepper_type =
+    tutorial::covariant_rk_stepper<field_type, free_track_parameters,
+                                   constrained_step<>>;
+using actor_chain_type = actor_chain<std::tuple, tutorial::module_recorder,
+                                     tutorial::covariance_recorder>;
+
+/// Actor states of all tracks of a run
+struct run_states
+{
+    std::vector<tutorial::module_recorder::state> modules;
+    std::vector<tutorial::covariance_recorder::state> covariances;
+
+    explicit run_states(const std::size_t n_tracks)
+        : modules(n_tracks), covariances(n_tracks)
+    {
+    }
+
+    actor_chain_type::state operator()(const std::size_t trk)
+    {
+        return std::tie(modules[trk], covariances[trk]);
+    }
+
+    std::size_t n_steps() const
+    {
+        std::size_t n{0};
+        for (const auto &rec : modules)
+        {
+            n += rec.n_steps();
+        }
+        return n;
+    }
+};
+
+void print(const std::string &name, const run_states &states,
+           const double time)
+{
+    const std::size_t n_steps = states.n_steps();
+    const std::size_t n_tracks = states.modules.size();
+    std::cout << std::setw(26) << std::left << name << std::right
+              << "steps/track: " << std::setw(8)
+              << static_cast<double>(n_steps) / n_tracks
+              << "   time [s]: " << std::setw(10) << time
+              << "   steps/s: " << std::setw(10) << n_steps / time;
+}
+
+/// Largest relative deviation of the covariances on the modules
+scalar max_deviation(const run_states &ref, const run_states &res)
+{
+    scalar max_dev{0.};
+    for (std::size_t trk = 0; trk < ref.covariances.size(); ++trk)
+    {
+        const auto &ref_covs = ref.covariances[trk].on_modules;
+        const auto &res_covs = res.covariances[trk].on_modules;
+        if (ref_covs.size() != res_covs.size())
+        {
+            return std::numeric_limits<scalar>::infinity();
+        }
+        for (std::size_t k = 0; k < ref_covs.size(); ++k)
+        {
+            for (std::size_t i = 0; i < tutorial::e_free_size; ++i)
+            {
+                for (std::size_t j = 0; j < tutorial::e_free_size; ++j)
+                {
+                    const scalar r = ref_covs[k].m[i][j][0];
+                    const scalar d = std::abs(res_covs[k].m[i][j][0] - r);
+                    max_dev = std::max(
+                        max_dev, d / std::max(std::abs(r), scalar{1e-6}));
+                }
+            }
+        }
+    }
+    return max_dev;
+}
+
+/// Propagate in lockstep batches of W tracks and compare to @param ref
+template <std::size_t W, typename detector_t>
+void run_lockstep(const detector_t &det, const field_type &B_field,
+                  const std::vector<free_track_parameters> &tracks,
+                  const tutorial::free_matrix &initial_cov,
+                  const run_states &ref)
+{
+    tutorial::lockstep_propagator<W, covariant_stepper_type, detector_t,
+                                  actor_chain_type>
+        p(covariant_stepper_type{B_field}, det);
+
+    run_states states(tracks.size());
+
+    /*time*/ auto start_time = std::chrono::system_clock::now();
+
+    p.propagate(tracks, initial_cov, states);
+
+    /*time*/ auto end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> time = end_time - start_time;
+
+    print("lockstep (W = " + std::to_string(W) + ")", states, time.count());
+    std::cout << "   max. rel. deviation: " << max_deviation(ref, states)
+              << std::endl;
+}
+
+}  // anonymous namespace
+
+int main()
+{
+    /*****************
+     * Initial Setup *
+     *****************/
+
+    // Track batch setup (100 X 100 == 10000 tracks)
+    constexpr std::size_t n_theta_steps = 100;
+    constexpr std::size_t n_phi_steps = 100;
+
+    // Detector setup for the number of layers
+    constexpr std::size_t n_barrel_layers = 4;
+    constexpr std::size_t n_endcap_layers = 7;
+
+    // Set up the constant magnetic field
+    const vector3 B{0, 0, 2 * unit_constants::T};
+    field_type B_field(B);
+
+    // VecMem memory resource(s)
+    vecmem::host_memory_resource host_resource;
+
+    // Create the TrackML (toy) geometry
+    auto detector =
+        create_toy_geometry(host_resource, n_barrel_layers, n_endcap_layers);
+    using detector_type = decltype(detector);
+    using navigator_type = navigator<detector_type>;
+
+    // Create a batch of tracks
+    std::vector<free_track_parameters> tracks;
+    const point3 ori{0., 0., 0.};
+    for (auto track : uniform_track_generator<free_track_parameters>(
+             n_theta_steps, n_phi_steps, ori, 10. * unit_constants::GeV))
+    {
+        track.set_overstep_tolerance(-7. * unit_constants::um);
+        tracks.push_back(track);
+    }
+
+    // Initial covariance: 10 um, 1 mrad and 1 % in q/p, uncorrelated. The time
+    // is not transported and only gets a unit variance.
+    tutorial::free_matrix initial_cov = tutorial::free_matrix::identity();
+    const std::array<scalar, tutorial::e_free_size> sigmas{
+        10. * unit_constants::um, 10. * unit_constants::um,
+        10. * unit_constants::um, 1.,
+        1e-3f, 1e-3f, 1e-3f, 1e-2f * tracks.front().qop()};
+    for (std::size_t i = 0; i < tutorial::e_free_size; ++i)
+    {
+        initial_cov.m[i][i][0] = sigmas[i] * sigmas[i];
+    }
+
+    std::cout << "Tracks: " << tracks.size() << std::endl;
+
+    propagator<covariant_stepper_type, navigator_type, actor_chain_type> p(
+        covariant_stepper_type{B_field}, navigator_type{detector});
+
+    // Propagate one track after the other with the transport @param mode
+    const auto run_per_track = [&](const tutorial::transport_mode mode,
+                                   run_states &states) {
+        /*time*/ auto start_time = std::chrono::system_clock::now();
+
+        for (std::size_t trk = 0; trk < tracks.size(); ++trk)
+        {
+            decltype(p)::state state(tracks[trk], states(trk));
+            state._stepping.covariance = initial_cov;
+            state._stepping.mode = mode;
+            p.propagate(state);
+        }
+
+        /*time*/ auto end_time = std::chrono::system_clock::now();
+        /*time*/ std::chrono::duration<double> time = end_time - start_time;
+
+        return time.count();
+    };
+
+    /****************
+     * No transport *
+     ****************/
+
+    run_states no_transport(tracks.size());
+    const double no_transport_time =
+        run_per_track(tutorial::transport_mode::e_none, no_transport);
+    print("no transport", no_transport, no_transport_time);
+    std::cout << std::endl;
+
+    /***********************
+     * Per-track transport *
+     ***********************/
+
+    run_states ref(tracks.size());
+    const double ref_time =
+        run_per_track(tutorial::transport_mode::e_covariance, ref);
+    print("per track", ref, ref_time);
+    std::cout << std::endl;
+
+    /**********************
+     * Lockstep transport *
+     **********************/
+
+    run_lockstep<4>(detector, B_field, tracks, initial_cov, ref);
+    run_lockstep<8>(detector, B_field, tracks, initial_cov, ref);
+    run_lockstep<16>(detector, B_field, tracks, initial_cov, ref);
+
+    return 0;
+}
@@ -21,9 +21,14 @@
 #include "tests/common/tools/inspectors.hpp"
 #include "tests/common/tools/track_generators.hpp"
 
+// tutorial includes
+#include "volume_grid_index.hpp"
+
 // vecmem includes
 #include <vecmem/memory/host_memory_resource.hpp>
 
+#include <cstdlib>
+#include <iostream>
 #include <sstream>
 
 using namespace detray;
@@ -69,8 +74,15 @@ int main()
     constexpr std::size_t theta_steps{10};
     constexpr std::size_t phi_steps{10};
 
-    // det.volume_by_pos(ori).index();
+    // Find the start volume of the tracks
     const point3 ori{0., 0., 0.};
+    const tutorial::volume_grid_index<decltype(det)> volume_index(det);
+    const dindex start_volume = volume_index.find(ori);
+    if (start_volume == dindex_invalid) {
+        std::cerr << "The origin (" << ori[0] << ", " << ori[1] << ", "
+                  << ori[2] << ") is outside of the detector" << std::endl;
+        return EXIT_FAILURE;
+    }
     constexpr scalar p_mag{10. * unit_constants::GeV};
 
     // Test parameters
@@ -95,6 +107,7 @@ int main()
 
         // Init propagator state
         propagator_t::state p_state(track, actor_states);
+        p_state._navigation.set_volume(start_volume);
 
         // Set step constraints (the most strict will be applied)
         p_state._stepping
@@ -0,0 +1,187 @@
+/** Detray tutorial project, No copy right **/
+
+// This tutorial compares the Runge-Kutta stepper with the analytic helix
+// stepper in the constant magnetic field of the toy detector:
+// 1. Propagate the same track batch with the RK stepper (with and without the
+//    30 mm accuracy constraint of the other tutorials) and with the helix
+//    stepper
+// 2. Compare the track position on every module to the ground truth helix at
+//    the same path length
+// 3. Compare the sequence of modules found to the helix particle gun
+// The steps/s and the accuracy of every stepper are printed.
+
+// Detray include(s).
+#include "detray/plugins/algebra/array_definitions.hpp"
+#include "detray/definitions/units.hpp"
+#include "detray/field/constant_magnetic_field.hpp"
+#include "detray/intersection/detail/trajectories.hpp"
+#include "detray/propagator/actor_chain.hpp"
+#include "detray/propagator/navigator.hpp"
+#include "detray/propagator/propagator.hpp"
+#include "detray/propagator/rk_stepper.hpp"
+#include "detray/propagator/track.hpp"
+#include "tests/common/tools/create_toy_geometry.hpp"
+#include "tests/common/tools/track_generators.hpp"
+
+// Project include(s).
+#include "helix_stepper.hpp"
+#include "navigation_validation.hpp"
+
+// Vecmem include(s).
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace detray;
+
+namespace {
+
+/// Propagate all @param tracks with @param stepper_t and compare to the truth
+template <typename stepper_t, typename detector_t, typename field_t>
+void run(const std::string &name, const detector_t &det,
+         const field_t &B_field, const vector3 &B,
+         const std::vector<free_track_parameters> &tracks,
+         const std::vector<std::vector<dindex>> &truth_traces,
+         const scalar step_constr)
+{
+    using navigator_type = navigator<detector_t>;
+    using actor_chain_type =
+        actor_chain<std::tuple, tutorial::module_recorder>;
+    using propagator_type =
+        propagator<stepper_t, navigator_type, actor_chain_type>;
+
+    propagator_type p(stepper_t{B_field}, navigator_type{det});
+
+    std::vector<tutorial::module_recorder::state> recorder_states(
+        tracks.size());
+
+    /*time*/ auto start_time = std::chrono::system_clock::now();
+
+    for (std::size_t trk = 0; trk < tracks.size(); ++trk)
+    {
+        typename propagator_type::state state(
+            tracks[trk], std::tie(recorder_states[trk]));
+        if (step_constr > 0.)
+        {
+            state._stepping
+                .template set_constraint<step::constraint::e_accuracy>(
+                    step_constr);
+        }
+        p.propagate(state);
+    }
+
+    /*time*/ auto end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> time = end_time - start_time;
+
+    // Compare to the truth
+    std::size_t n_steps{0};
+    std::size_t n_hits{0};
+    std::size_t n_truth_modules{0};
+    std::size_t n_found{0};
+    std::size_t n_matched_tracks{0};
+    scalar max_residual{0.};
+    scalar sum_residual{0.};
+    for (std::size_t trk = 0; trk < tracks.size(); ++trk)
+    {
+        const auto &rec = recorder_states[trk];
+        const auto &truth_trace = truth_traces[trk];
+        const detail::helix truth(tracks[trk], &B);
+
+        n_steps += rec.n_steps();
+        n_hits += rec.modules.size();
+        n_truth_modules += truth_trace.size();
+        n_found += tutorial::n_found_modules(truth_trace, rec.modules);
+        n_matched_tracks += (rec.modules == truth_trace);
+
+        for (std::size_t i = 0; i < rec.modules.size(); ++i)
+        {
+            const auto diff = rec.positions[i] - truth.pos(rec.paths[i]);
+            const scalar residual = std::sqrt(
+                diff[0] * diff[0] + diff[1] * diff[1] + diff[2] * diff[2]);
+            max_residual = std::max(max_residual, residual);
+            sum_residual += residual;
+        }
+    }
+
+    std::cout << std::setw(22) << std::left << name << std::right
+              << "steps/track: " << std::setw(7) << std::setprecision(4)
+              << static_cast<double>(n_steps) / tracks.size()
+              << "   steps/s: " << std::setw(10) << n_steps / time.count()
+              << "   time [s]: " << std::setw(8) << time.count()
+              << "   mean/max residual [um]: " << std::setw(8)
+              << sum_residual / std::max<std::size_t>(n_hits, 1) /
+                     unit_constants::um
+              << " / " << std::setw(8) << max_residual / unit_constants::um
+              << "   modules found: " << n_found << "/"
+              << n_truth_modules
+              << "   tracks with identical module trace: "
+              << n_matched_tracks << "/" << tracks.size() << std::endl;
+}
+
+}  // anonymous namespace
+
+int main()
+{
+    /*****************
+     * Initial Setup *
+     *****************/
+
+    // Track batch setup (50 X 50 == 2500 tracks)
+    constexpr std::size_t n_theta_steps = 50;
+    constexpr std::size_t n_phi_steps = 50;
+
+    // Detector setup for the number of layers
+    constexpr std::size_t n_barrel_layers = 4;
+    constexpr std::size_t n_endcap_layers = 7;
+
+    // Set up the constant magnetic field
+    const vector3 B{0, 0, 2 * unit_constants::T};
+    constant_magnetic_field<> B_field(B);
+
+    // VecMem memory resource(s)
+    vecmem::host_memory_resource host_resource;
+
+    // Create the TrackML (toy) geometry
+    auto detector =
+        create_toy_geometry(host_resource, n_barrel_layers, n_endcap_layers);
+
+    // Create a batch of tracks and record the modules on their truth helices
+    std::vector<free_track_parameters> tracks;
+    std::vector<std::vector<dindex>> truth_traces;
+    const point3 ori{0., 0., 0.};
+    for (auto track : uniform_track_generator<free_track_parameters>(
+             n_theta_steps, n_phi_steps, ori, 10. * unit_constants::GeV))
+    {
+        track.set_overstep_tolerance(-7. * unit_constants::um);
+        tracks.push_back(track);
+        truth_traces.push_back(
+            tutorial::truth_module_trace(detector, track, B));
+    }
+
+    /**************
+     * Comparison *
+     **************/
+
+    using field_type = constant_magnetic_field<>;
+    using rk_stepper_type =
+        rk_stepper<field_type, free_track_parameters, constrained_step<>>;
+    using helix_stepper_type =
+        tutorial::helix_stepper<field_type, free_track_parameters,
+                                constrained_step<>>;
+
+    run<rk_stepper_type>("RK (30 mm constraint)", detector, B_field, B,
+                         tracks, truth_traces, 30 * unit_constants::mm);
+    run<rk_stepper_type>("RK (adaptive only)", detector, B_field, B, tracks,
+                         truth_traces, 0.);
+    run<helix_stepper_type>("helix", detector, B_field, B, tracks,
+                            truth_traces, 0.);
+
+    return 0;
+}
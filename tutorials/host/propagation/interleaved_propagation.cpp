@@ -0,0 +1,136 @@
+/** Detray tutorial project, No copy right **/
+
+// This tutorial propagates a track batch through the toy detector on a single
+// thread in two ways:
+// 1. One track after the other with propagator::propagate
+// 2. K tracks in flight, advanced by one step each in round-robin. After a
+//    step, the masks and transforms of the next two candidates of that track
+//    are prefetched, so the memory latency overlaps with the other K-1
+//    tracks.
+// The benchmark sweeps K with and without prefetching.
+
+// Detray include(s).
+#include "detray/plugins/algebra/array_definitions.hpp"
+#include "detray/definitions/units.hpp"
+#include "detray/field/constant_magnetic_field.hpp"
+#include "detray/propagator/actor_chain.hpp"
+#include "detray/propagator/navigator.hpp"
+#include "detray/propagator/propagator.hpp"
+#include "detray/propagator/rk_stepper.hpp"
+#include "detray/propagator/track.hpp"
+#include "tests/common/tools/create_toy_geometry.hpp"
+#include "tests/common/tools/track_generators.hpp"
+
+// Project include(s).
+#include "interleaved_propagator.hpp"
+
+// Vecmem include(s).
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace detray;
+
+int main()
+{
+    /*****************
+     * Initial Setup *
+     *****************/
+
+    // Track batch setup (100 X 100 == 10000 tracks)
+    constexpr std::size_t n_theta_steps = 100;
+    constexpr std::size_t n_phi_steps = 100;
+
+    // Detector setup for the number of layers
+    constexpr std::size_t n_barrel_layers = 4;
+    constexpr std::size_t n_endcap_layers = 7;
+
+    // Set up the constant magnetic field
+    const vector3 B{0, 0, 2 * unit_constants::T};
+    constant_magnetic_field<> B_field(B);
+
+    // VecMem memory resource(s)
+    vecmem::host_memory_resource host_resource;
+
+    // Create the TrackML (toy) geometry
+    auto detector =
+        create_toy_geometry(host_resource, n_barrel_layers, n_endcap_layers);
+    using detector_type = decltype(detector);
+
+    // Stepper, navigator and propagator types
+    using rk_stepper_type =
+        rk_stepper<constant_magnetic_field<>, free_track_parameters,
+                   constrained_step<>>;
+    using navigator_type = navigator<detector_type>;
+    using propagator_type =
+        propagator<rk_stepper_type, navigator_type, actor_chain<>>;
+    using interleaved_type =
+        tutorial::interleaved_propagator<rk_stepper_type, detector_type>;
+
+    // Create a batch of tracks
+    std::vector<free_track_parameters> tracks;
+    const point3 ori{0., 0., 0.};
+    for (auto track : uniform_track_generator<free_track_parameters>(
+             n_theta_steps, n_phi_steps, ori, 10. * unit_constants::GeV))
+    {
+        track.set_overstep_tolerance(-7. * unit_constants::um);
+        tracks.push_back(track);
+    }
+
+    /******************
+     * Track-by-track *
+     ******************/
+
+    propagator_type p(rk_stepper_type{B_field}, navigator_type{detector});
+
+    /*time*/ auto start_time = std::chrono::system_clock::now();
+
+    std::size_t n_success{0};
+    for (const auto &track : tracks)
+    {
+        propagator_type::state state(track);
+        n_success += p.propagate(state);
+    }
+
+    /*time*/ auto end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> ref_time = end_time - start_time;
+
+    std::cout << "track-by-track:        time [s]: " << std::setw(10)
+              << ref_time.count() << "   successful: " << n_success
+              << std::endl;
+
+    /*********************
+     * Interleaved sweep *
+     *********************/
+
+    for (const bool prefetch : {false, true})
+    {
+        for (const std::size_t K : {1, 2, 4, 8, 16, 32, 64})
+        {
+            interleaved_type ip(rk_stepper_type{B_field}, detector);
+
+            /*time*/ start_time = std::chrono::system_clock::now();
+
+            const std::size_t n_interleaved_success =
+                ip.propagate(tracks, K, prefetch);
+
+            /*time*/ end_time = std::chrono::system_clock::now();
+            /*time*/ std::chrono::duration<double> time =
+                end_time - start_time;
+
+            std::cout << "K = " << std::setw(2) << K
+                      << (prefetch ? ", prefetch:    " : ", no prefetch: ")
+                      << "time [s]: " << std::setw(10) << time.count()
+                      << "   speedup: " << std::setw(6) << std::setprecision(3)
+                      << ref_time.count() / time.count()
+                      << "   successful: " << n_interleaved_success
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
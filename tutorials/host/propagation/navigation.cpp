@@ -22,9 +22,14 @@
 #include "tests/common/tools/particle_gun.hpp"
 #include "tests/common/tools/track_generators.hpp"
 
+// tutorial includes
+#include "volume_grid_index.hpp"
+
 // vecmem includes
 #include <vecmem/memory/host_memory_resource.hpp>
 
+#include <cstdlib>
+#include <iostream>
 #include <sstream>
 
 using namespace detray;
@@ -64,8 +69,15 @@ int main()
     constexpr std::size_t theta_steps{1};
     constexpr std::size_t phi_steps{1};
 
-    // det.volume_by_pos(ori).index();
+    // Find the start volume of the tracks
     const point3 ori{0., 0., 0.};
+    const tutorial::volume_grid_index<decltype(det)> volume_index(det);
+    const dindex start_volume = volume_index.find(ori);
+    if (start_volume == dindex_invalid) {
+        std::cerr << "The origin (" << ori[0] << ", " << ori[1] << ", "
+                  << ori[2] << ") is outside of the detector" << std::endl;
+        return EXIT_FAILURE;
+    }
     constexpr scalar p_mag{10. * unit_constants::GeV};
 
     // Iterate through uniformly distributed momentum directions
@@ -83,6 +95,7 @@ int main()
         // Now follow that helix with the same track and check, if we find
         // the same volumes and distances along the way
         propagator_t::state propagation(track);
+        propagation._navigation.set_volume(start_volume);
 
         // Retrieve navigation information
         auto &inspector = propagation._navigation.inspector();
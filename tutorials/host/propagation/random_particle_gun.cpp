@@ -0,0 +1,155 @@
+/** Detray tutorial project, No copy right **/
+
+// This tutorial generates random tracks (flat momentum, eta and phi, gaussian
+// vertex smearing, random charge) with a counter-based random number
+// generator:
+// 1. Fill a vecmem track batch serially as a reference
+// 2. Fill it again in parallel for an increasing number of threads and check
+//    that the result is bit-identical to the reference
+// 3. Fill a structure-of-arrays batch in parallel
+// The fill throughput in tracks/s and GB/s is printed.
+
+// Detray include(s).
+#include "detray/plugins/algebra/array_definitions.hpp"
+#include "detray/definitions/units.hpp"
+#include "detray/propagator/track.hpp"
+
+// Project include(s).
+#include "random_track_generator.hpp"
+
+// Vecmem include(s).
+#include <vecmem/containers/vector.hpp>
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace detray;
+
+namespace {
+
+/// Bitwise comparison of the track parameters (not of the padding)
+bool is_identical(const free_track_parameters &a,
+                  const free_track_parameters &b)
+{
+    const auto equal = [](const auto &lhs, const auto &rhs) {
+        return std::memcmp(&lhs, &rhs, sizeof(lhs)) == 0;
+    };
+    return equal(a.pos(), b.pos()) and equal(a.mom(), b.mom()) and
+           equal(a.charge(), b.charge()) and equal(a.time(), b.time());
+}
+
+void print(const std::string &name, const std::size_t n_tracks,
+           const std::size_t n_bytes, const double time)
+{
+    std::cout << std::setw(24) << std::left << name << std::right
+              << "time [s]: " << std::setw(10) << time
+              << "   tracks/s: " << std::setw(10) << n_tracks / time
+              << "   GB/s: " << std::setw(8) << 1e-9 * n_bytes / time;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    /*****************
+     * Initial Setup *
+     *****************/
+
+    // Number of tracks (default 4M)
+    std::size_t n_tracks{1ul << 22};
+    if (argc == 2)
+    {
+        n_tracks = std::stoul(argv[1]);
+    }
+
+    const std::size_t max_threads =
+        std::max(1u, std::thread::hardware_concurrency());
+
+    // VecMem memory resource(s)
+    vecmem::host_memory_resource host_resource;
+
+    // Particle gun configuration
+    using generator_type =
+        tutorial::random_track_generator<free_track_parameters>;
+    generator_type::configuration cfg{};
+    cfg.seed = 1234;
+    cfg.p_min = 1. * unit_constants::GeV;
+    cfg.p_max = 100. * unit_constants::GeV;
+    const generator_type gun(cfg);
+
+    std::cout << "Tracks: " << n_tracks << ", track size: "
+              << sizeof(free_track_parameters) << " bytes" << std::endl;
+
+    /**********************
+     * Serial (reference) *
+     **********************/
+
+    vecmem::vector<free_track_parameters> reference(n_tracks, &host_resource);
+    const std::size_t n_bytes = n_tracks * sizeof(free_track_parameters);
+
+    /*time*/ auto start_time = std::chrono::system_clock::now();
+
+    gun.generate(0, reference.size(), reference.begin());
+
+    /*time*/ auto end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> time = end_time - start_time;
+
+    print("serial", n_tracks, n_bytes, time.count());
+    std::cout << std::endl;
+
+    /************
+     * Parallel *
+     ************/
+
+    vecmem::vector<free_track_parameters> tracks(n_tracks, &host_resource);
+
+    for (std::size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+    {
+        std::fill(tracks.begin(), tracks.end(), free_track_parameters{});
+
+        /*time*/ start_time = std::chrono::system_clock::now();
+
+        gun.fill_parallel(tracks, n_threads);
+
+        /*time*/ end_time = std::chrono::system_clock::now();
+        /*time*/ time = end_time - start_time;
+
+        bool identical{true};
+        for (std::size_t i = 0; identical and i < n_tracks; ++i)
+        {
+            identical &= is_identical(tracks[i], reference[i]);
+        }
+
+        print("vecmem, " + std::to_string(n_threads) + " thread(s)",
+              n_tracks, n_bytes, time.count());
+        std::cout << "   identical: " << std::boolalpha << identical
+                  << std::endl;
+    }
+
+    /*******
+     * SoA *
+     *******/
+
+    tutorial::track_batch_soa batch(n_tracks);
+    const std::size_t n_soa_bytes = n_tracks * 7 * sizeof(scalar);
+
+    /*time*/ start_time = std::chrono::system_clock::now();
+
+    tutorial::fill_parallel(gun, batch, max_threads);
+
+    /*time*/ end_time = std::chrono::system_clock::now();
+    /*time*/ time = end_time - start_time;
+
+    print("SoA, " + std::to_string(max_threads) + " thread(s)", n_tracks,
+          n_soa_bytes, time.count());
+    std::cout << std::endl;
+
+    return 0;
+}
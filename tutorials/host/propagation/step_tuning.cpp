@@ -0,0 +1,303 @@
+/** Detray tutorial project, No copy right **/
+
+// This tutorial tunes the step size constraint and the overstep tolerance of
+// the Runge-Kutta propagation for the toy detector:
+// 1. Generate a random track batch and record the modules on the truth helix
+//    of every track with the particle gun
+// 2. Propagate the batch for every combination of accuracy constraint and
+//    overstep tolerance and compare the module sequence found to the truth
+// 3. Print the throughput and the navigation efficiency of every setting and
+//    the settings on the Pareto front of the two
+// After a warm-up pass, every setting is timed several times and the best
+// time is kept. Run it with a larger batch for more stable numbers.
+
+// Detray include(s).
+#include "detray/plugins/algebra/array_definitions.hpp"
+#include "detray/definitions/units.hpp"
+#include "detray/field/constant_magnetic_field.hpp"
+#include "detray/propagator/actor_chain.hpp"
+#include "detray/propagator/navigator.hpp"
+#include "detray/propagator/propagator.hpp"
+#include "detray/propagator/rk_stepper.hpp"
+#include "detray/propagator/track.hpp"
+#include "tests/common/tools/create_toy_geometry.hpp"
+
+// Project include(s).
+#include "navigation_validation.hpp"
+#include "random_track_generator.hpp"
+#include "volume_grid_index.hpp"
+
+// Vecmem include(s).
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace detray;
+
+namespace {
+
+/// Result of one parameter setting
+struct tuning_point
+{
+    /// Accuracy step constraint, zero if unconstrained
+    scalar step_constr{0.};
+    scalar overstep_tol{0.};
+    double tracks_per_s{0.};
+    double steps_per_track{0.};
+    /// Fraction of tracks that found exactly the module sequence of their
+    /// truth helix
+    double track_eff{0.};
+    /// Truth modules found over all truth modules
+    double module_eff{0.};
+    bool is_pareto{false};
+};
+
+/// A point is on the Pareto front, if no other point is at least as fast and
+/// as efficient, and better in one of the two
+void mark_pareto_front(std::vector<tuning_point> &points)
+{
+    for (auto &p : points)
+    {
+        p.is_pareto = std::none_of(
+            points.begin(), points.end(), [&p](const tuning_point &q) {
+                return q.tracks_per_s >= p.tracks_per_s and
+                       q.track_eff >= p.track_eff and
+                       (q.tracks_per_s > p.tracks_per_s or
+                        q.track_eff > p.track_eff);
+            });
+    }
+}
+
+void print(const tuning_point &p)
+{
+    std::cout << std::setw(12);
+    if (p.step_constr > 0.)
+    {
+        std::cout << p.step_constr / unit_constants::mm;
+    }
+    else
+    {
+        std::cout << "-";
+    }
+    std::cout << std::setw(12) << p.overstep_tol / unit_constants::um
+              << std::setw(12) << p.tracks_per_s << std::setw(12)
+              << p.steps_per_track << std::setw(12) << p.track_eff
+              << std::setw(12) << p.module_eff << std::endl;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    /*****************
+     * Initial Setup *
+     *****************/
+
+    // Number of tracks (default 2500)
+    std::size_t n_tracks{2500};
+    if (argc == 2)
+    {
+        n_tracks = std::stoul(argv[1]);
+    }
+
+    // Detector setup for the number of layers
+    constexpr std::size_t n_barrel_layers = 4;
+    constexpr std::size_t n_endcap_layers = 7;
+
+    // Set up the constant magnetic field
+    const vector3 B{0, 0, 2 * unit_constants::T};
+    constant_magnetic_field<> B_field(B);
+
+    // VecMem memory resource(s)
+    vecmem::host_memory_resource host_resource;
+
+    // Create the TrackML (toy) geometry
+    auto detector =
+        create_toy_geometry(host_resource, n_barrel_layers, n_endcap_layers);
+    using detector_type = decltype(detector);
+
+    const tutorial::volume_grid_index<detector_type> volume_index(detector);
+
+    // Random track batch (1 - 10 GeV, |eta| < 2.5) with smeared vertices
+    using generator_type =
+        tutorial::random_track_generator<free_track_parameters>;
+    generator_type::configuration cfg{};
+    cfg.seed = 4321;
+    const generator_type gun(cfg);
+
+    std::vector<free_track_parameters> generated(n_tracks);
+    gun.generate(0, n_tracks, generated.begin());
+
+    // Start volume and truth modules of every track. The vertex smearing can
+    // put a vertex outside of the detector, such tracks are skipped.
+    std::vector<free_track_parameters> tracks;
+    std::vector<dindex> start_volumes;
+    std::vector<std::vector<dindex>> truth_traces;
+    std::size_t truth_total{0};
+    for (const auto &track : generated)
+    {
+        const dindex start_volume = volume_index.find(track.pos());
+        if (start_volume == dindex_invalid)
+        {
+            continue;
+        }
+        tracks.push_back(track);
+        start_volumes.push_back(start_volume);
+        truth_traces.push_back(
+            tutorial::truth_module_trace(detector, track, B));
+        truth_total += truth_traces.back().size();
+    }
+    const std::size_t n_skipped = n_tracks - tracks.size();
+    n_tracks = tracks.size();
+
+    /*********
+     * Sweep *
+     *********/
+
+    using field_type = constant_magnetic_field<>;
+    using stepper_type =
+        rk_stepper<field_type, free_track_parameters, constrained_step<>>;
+    using navigator_type = navigator<detector_type>;
+    using actor_chain_type =
+        actor_chain<std::tuple, tutorial::module_recorder>;
+    using propagator_type =
+        propagator<stepper_type, navigator_type, actor_chain_type>;
+
+    propagator_type p(stepper_type{B_field}, navigator_type{detector});
+
+    // Zero means no accuracy constraint (only the adaptive step size)
+    const std::vector<scalar> step_constraints{
+        5. * unit_constants::mm,  10. * unit_constants::mm,
+        30. * unit_constants::mm, 10. * unit_constants::cm,
+        30. * unit_constants::cm, 0.};
+    const std::vector<scalar> overstep_tolerances{
+        -1. * unit_constants::um, -7. * unit_constants::um,
+        -50. * unit_constants::um, -100. * unit_constants::um};
+
+    // Timed repetitions of every setting, the fastest one counts
+    constexpr std::size_t n_repetitions = 5;
+
+    std::vector<tuning_point> points;
+    std::vector<tutorial::module_recorder::state> recorder_states(n_tracks);
+
+    // Propagate the batch with one setting, returns the time in seconds
+    const auto run_setting = [&](const scalar step_constr,
+                                 const scalar overstep_tol) {
+        std::fill(recorder_states.begin(), recorder_states.end(),
+                  tutorial::module_recorder::state{});
+
+        /*time*/ auto start_time = std::chrono::system_clock::now();
+
+        for (std::size_t trk = 0; trk < n_tracks; ++trk)
+        {
+            auto track = tracks[trk];
+            track.set_overstep_tolerance(overstep_tol);
+
+            propagator_type::state state(track,
+                                         std::tie(recorder_states[trk]));
+            state._navigation.set_volume(start_volumes[trk]);
+            if (step_constr > 0.)
+            {
+                state._stepping
+                    .template set_constraint<step::constraint::e_accuracy>(
+                        step_constr);
+            }
+            p.propagate(state);
+        }
+
+        /*time*/ auto end_time = std::chrono::system_clock::now();
+        /*time*/ std::chrono::duration<double> time = end_time - start_time;
+
+        return time.count();
+    };
+
+    // Warm up the caches, so that the first setting is not penalized
+    run_setting(step_constraints.front(), overstep_tolerances.front());
+
+    for (const scalar step_constr : step_constraints)
+    {
+        for (const scalar overstep_tol : overstep_tolerances)
+        {
+            double time{std::numeric_limits<double>::max()};
+            for (std::size_t rep = 0; rep < n_repetitions; ++rep)
+            {
+                time = std::min(time, run_setting(step_constr, overstep_tol));
+            }
+
+            // Compare to the truth
+            std::size_t n_steps{0};
+            std::size_t n_found{0};
+            std::size_t n_matched_tracks{0};
+            for (std::size_t trk = 0; trk < n_tracks; ++trk)
+            {
+                const auto &rec = recorder_states[trk];
+                n_steps += rec.n_steps();
+                n_found +=
+                    tutorial::n_found_modules(truth_traces[trk], rec.modules);
+                n_matched_tracks += (rec.modules == truth_traces[trk]);
+            }
+
+            tuning_point point{};
+            point.step_constr = step_constr;
+            point.overstep_tol = overstep_tol;
+            point.tracks_per_s = n_tracks / time;
+            point.steps_per_track = static_cast<double>(n_steps) / n_tracks;
+            point.track_eff = static_cast<double>(n_matched_tracks) / n_tracks;
+            point.module_eff = static_cast<double>(n_found) /
+                               std::max<std::size_t>(truth_total, 1);
+            points.push_back(point);
+        }
+    }
+
+    /**********
+     * Result *
+     **********/
+
+    mark_pareto_front(points);
+
+    const auto print_header = []() {
+        std::cout << std::setw(12) << "constr [mm]" << std::setw(12)
+                  << "tol [um]" << std::setw(12) << "tracks/s"
+                  << std::setw(12) << "steps/trk" << std::setw(12)
+                  << "track eff" << std::setw(12) << "module eff"
+                  << std::endl;
+    };
+
+    std::cout << "Tracks: " << n_tracks << " (" << n_skipped
+              << " skipped, vertex outside of the detector), truth modules: "
+              << truth_total << std::endl
+              << std::endl;
+    std::cout << std::setprecision(4);
+    print_header();
+    for (const auto &point : points)
+    {
+        print(point);
+    }
+
+    // Pareto front, fastest first
+    std::vector<tuning_point> front;
+    std::copy_if(points.begin(), points.end(), std::back_inserter(front),
+                 [](const tuning_point &point) { return point.is_pareto; });
+    std::sort(front.begin(), front.end(),
+              [](const tuning_point &a, const tuning_point &b) {
+                  return a.tracks_per_s > b.tracks_per_s;
+              });
+
+    std::cout << std::endl << "Pareto front:" << std::endl;
+    print_header();
+    for (const auto &point : front)
+    {
+        print(point);
+    }
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+/** Detray tutorial project, No copy right **/
+
+// This tutorial records a timeline of the propagation of a sampled subset of
+// tracks:
+// 1. The track batch is split over all hardware threads
+// 2. For one track in N (chosen by a hash of the track id), the start and end
+//    of the navigator, stepper and actor phases are written into the buffer
+//    of the thread; all other tracks run the untraced propagation loop
+// 3. The events are exported as Chrome trace JSON, which can be opened in
+//    chrome://tracing or ui.perfetto.dev
+// The run time with and without sampling and the slowest sampled tracks are
+// printed.
+
+// Detray include(s).
+#include "detray/plugins/algebra/array_definitions.hpp"
+#include "detray/definitions/units.hpp"
+#include "detray/field/constant_magnetic_field.hpp"
+#include "detray/propagator/rk_stepper.hpp"
+#include "detray/propagator/track.hpp"
+#include "tests/common/tools/create_toy_geometry.hpp"
+#include "tests/common/tools/track_generators.hpp"
+
+// Project include(s).
+#include "timeline_tracer.hpp"
+
+// Vecmem include(s).
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace detray;
+
+namespace {
+
+/// Propagate @param tracks on @param n_threads threads, tracing into
+/// @param tracer. Returns the wall time in seconds.
+template <typename detector_t, typename field_t>
+double run(const detector_t &det, const field_t &B_field,
+           const std::vector<free_track_parameters> &tracks,
+           tutorial::timeline_tracer &tracer, const std::size_t n_threads)
+{
+    using rk_stepper_type =
+        rk_stepper<field_t, free_track_parameters, constrained_step<>>;
+    using traced_propagator_type =
+        tutorial::traced_propagator<rk_stepper_type, detector_t>;
+
+    /*time*/ auto start_time = std::chrono::system_clock::now();
+
+    std::vector<std::thread> threads;
+    for (std::size_t tid = 0; tid < n_threads; ++tid)
+    {
+        threads.emplace_back([&, tid]() {
+            traced_propagator_type p(rk_stepper_type{B_field}, det);
+            auto &buffer = tracer.buffer(tid);
+
+            // Contiguous block of tracks per thread
+            const std::size_t begin = tid * tracks.size() / n_threads;
+            const std::size_t end = (tid + 1) * tracks.size() / n_threads;
+            for (std::size_t trk = begin; trk < end; ++trk)
+            {
+                typename traced_propagator_type::state state(tracks[trk]);
+                p.propagate(state, trk,
+                            tracer.is_sampled(trk) ? &buffer : nullptr);
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    /*time*/ auto end_time = std::chrono::system_clock::now();
+    /*time*/ std::chrono::duration<double> time = end_time - start_time;
+
+    return time.count();
+}
+
+}  // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    /*****************
+     * Initial Setup *
+     *****************/
+
+    // Trace one track in sample_interval
+    std::size_t sample_interval{100};
+    if (argc >= 2)
+    {
+        sample_interval = std::stoul(argv[1]);
+    }
+    // Steps a sampled track may take before its events are dropped
+    std::size_t max_steps{500};
+    if (argc >= 3)
+    {
+        max_steps = std::stoul(argv[2]);
+    }
+    std::cout << "Tracing one in " << sample_interval << " tracks"
+              << std::endl;
+
+    const std::string trace_file{"propagation_trace.json"};
+
+    // Track batch setup (100 X 100 == 10000 tracks)
+    constexpr std::size_t n_theta_steps = 100;
+    constexpr std::size_t n_phi_steps = 100;
+
+    // Detector setup for the number of layers
+    constexpr std::size_t n_barrel_layers = 4;
+    constexpr std::size_t n_endcap_layers = 7;
+
+    const std::size_t n_threads =
+        std::max(1u, std::thread::hardware_concurrency());
+
+    // Set up the constant magnetic field
+    const vector3 B{0, 0, 2 * unit_constants::T};
+    constant_magnetic_field<> B_field(B);
+
+    // VecMem memory resource(s)
+    vecmem::host_memory_resource host_resource;
+
+    // Create the TrackML (toy) geometry
+    auto detector =
+        create_toy_geometry(host_resource, n_barrel_layers, n_endcap_layers);
+
+    // Create a batch of tracks
+    std::vector<free_track_parameters> tracks;
+    const point3 ori{0., 0., 0.};
+    for (auto track : uniform_track_generator<free_track_parameters>(
+             n_theta_steps, n_phi_steps, ori, 10. * unit_constants::GeV))
+    {
+        track.set_overstep_tolerance(-7. * unit_constants::um);
+        tracks.push_back(track);
+    }
+
+    /***************
+     * Propagation *
+     ***************/
+
+    tutorial::timeline_tracer no_tracing(n_threads, 0, 0);
+    const double ref_time =
+        run(detector, B_field, tracks, no_tracing, n_threads);
+
+    tutorial::timeline_tracer tracer(
+        n_threads, sample_interval,
+        tutorial::timeline_tracer::expected_capacity(
+            tracks.size(), n_threads, sample_interval, max_steps));
+    const double traced_time =
+        run(detector, B_field, tracks, tracer, n_threads);
+
+    std::cout << "Threads: " << n_threads << std::endl;
+    std::cout << "time without tracing [s]: " << ref_time << std::endl;
+    std::cout << "time with sampled tracing [s]: " << traced_time
+              << std::endl;
+
+    /**********
+     * Export *
+     **********/
+
+    std::ofstream out(trace_file);
+    tracer.write_chrome_trace(out);
+
+    // Collect the per-track events to find the tail
+    std::vector<tutorial::trace_event> track_events;
+    std::size_t n_events{0};
+    std::size_t n_dropped{0};
+    for (const auto &buffer : tracer.buffers())
+    {
+        n_events += buffer.events().size();
+        n_dropped += buffer.n_dropped();
+        for (const auto &e : buffer.events())
+        {
+            if (e.phase == tutorial::trace_phase::e_track)
+            {
+                track_events.push_back(e);
+            }
+        }
+    }
+    std::cout << "Sampled tracks: " << track_events.size()
+              << ", events: " << n_events << ", dropped: " << n_dropped
+              << " -> " << trace_file << std::endl;
+
+    std::sort(track_events.begin(), track_events.end(),
+              [](const auto &a, const auto &b) {
+                  return (a.end - a.start) > (b.end - b.start);
+              });
+    std::cout << "Slowest sampled tracks:" << std::endl;
+    for (std::size_t i = 0; i < std::min<std::size_t>(5, track_events.size());
+         ++i)
+    {
+        const auto &e = track_events[i];
+        std::cout << "  track " << e.track_id << ": "
+                  << (e.end - e.start) / 1000. << " us" << std::endl;
+    }
+
+    return 0;
+}